@@ -0,0 +1,447 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "lesson_engine.h"
+#include "rng.h"
+#include "utf8.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Latencies in buckets of a power of two split in four, so every bucket is
+// within 25% of its values, from nanoseconds to minutes in 256 counters.
+class LatencyHistogram {
+public:
+    void record(const Clock::duration latency) {
+        const auto ns = static_cast<uint64_t>(std::max<Clock::rep>(latency.count(), 1));
+        ++counts_[bucket_of(ns)];
+        ++count_;
+        total_ns_ += ns;
+        max_ns_ = std::max(max_ns_, ns);
+    }
+
+    [[nodiscard]] size_t count() const { return count_; }
+
+    // Upper bound of the bucket holding the `p`-quantile, at most the maximum.
+    [[nodiscard]] uint64_t percentile(const double p) const {
+        const auto rank = static_cast<size_t>(p * static_cast<double>(count_ - 1)) + 1;
+        size_t seen = 0;
+        for (size_t b = 0; b < counts_.size(); ++b) {
+            seen += counts_[b];
+            if (seen >= rank) {
+                return std::min(upper_bound_of(b), max_ns_);
+            }
+        }
+        return max_ns_;
+    }
+
+    void print(const std::string_view name) const {
+        if (count_ == 0) {
+            std::println("{}: none", name);
+            return;
+        }
+        std::println("{}: {} timed, mean {}, p50 {}, p90 {}, p99 {}, p99.9 {}, max {}", name, count_,
+                     format_ns(total_ns_ / count_), format_ns(percentile(0.5)), format_ns(percentile(0.9)),
+                     format_ns(percentile(0.99)), format_ns(percentile(0.999)), format_ns(max_ns_));
+
+        // One row per power of two, with a bar scaled to the largest row.
+        std::array<size_t, 64> rows{};
+        for (size_t b = 0; b < counts_.size(); ++b) {
+            rows[b / sub_buckets] += counts_[b];
+        }
+        const size_t largest = *std::ranges::max_element(rows);
+        const auto first = static_cast<size_t>(std::ranges::find_if(rows, [](const size_t n) { return n != 0; }) -
+                                               rows.begin());
+        const size_t last = rows.size() - static_cast<size_t>(std::ranges::find_if(rows.rbegin(), rows.rend(),
+                                                                                   [](const size_t n) {
+                                                                                       return n != 0;
+                                                                                   }) - rows.rbegin());
+        for (size_t r = first; r < last; ++r) {
+            constexpr size_t bar_width = 40;
+            std::println("  {:>8} - {:<8} {:<{}} {}", format_ns(uint64_t{1} << r), format_ns(uint64_t{2} << r),
+                         std::string(rows[r] * bar_width / largest, '#'), bar_width, rows[r]);
+        }
+    }
+
+private:
+    static constexpr size_t sub_buckets = 4;
+
+    static size_t bucket_of(const uint64_t ns) {
+        const auto power = static_cast<size_t>(std::bit_width(ns) - 1);
+        const size_t sub = power >= 2 ? (ns >> (power - 2)) & (sub_buckets - 1) : 0;
+        return power * sub_buckets + sub;
+    }
+
+    static uint64_t upper_bound_of(const size_t bucket) {
+        const size_t power = bucket / sub_buckets;
+        const size_t sub = bucket % sub_buckets;
+        return power >= 2 ? (uint64_t{1} << power) + ((sub + 1) << (power - 2)) : uint64_t{2} << power;
+    }
+
+    static std::string format_ns(const uint64_t ns) {
+        if (ns < 1'000) {
+            return std::format("{} ns", ns);
+        }
+        if (ns < 1'000'000) {
+            return std::format("{:.1f} us", static_cast<double>(ns) / 1e3);
+        }
+        return std::format("{:.1f} ms", static_cast<double>(ns) / 1e6);
+    }
+
+    std::array<size_t, 64 * sub_buckets> counts_{};
+    size_t count_ = 0;
+    uint64_t total_ns_ = 0;
+    uint64_t max_ns_ = 0;
+};
+
+// Just enough JSON for session lines: objects, strings, integers and arrays
+// are read, anything else is skipped over.
+class JsonReader {
+public:
+    explicit JsonReader(const std::string_view text) : text_(text) {}
+
+    [[nodiscard]] bool at_end() {
+        skip_space();
+        return pos_ == text_.size();
+    }
+
+    // Calls on_member(key) for every member; it must read the value.
+    template<typename F>
+    bool object(F &&on_member) {
+        if (!consume('{')) {
+            return false;
+        }
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            const auto key = string();
+            if (!key.has_value() || !consume(':') || !on_member(key.value())) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}');
+    }
+
+    // Calls on_element() for every element; it must read the value.
+    template<typename F>
+    bool array(F &&on_element) {
+        if (!consume('[')) {
+            return false;
+        }
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            if (!on_element()) {
+                return false;
+            }
+        } while (consume(','));
+        return consume(']');
+    }
+
+    std::optional<std::string> string() {
+        if (!consume('"')) {
+            return std::nullopt;
+        }
+        std::string out;
+        while (pos_ < text_.size()) {
+            const char c = text_[pos_++];
+            if (c == '"') {
+                return out;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ == text_.size()) {
+                return std::nullopt;
+            }
+            switch (const char escaped = text_[pos_++]) {
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    auto c32 = hex4();
+                    if (c32.has_value() && *c32 >= 0xD800 && *c32 < 0xDC00 && text_.substr(pos_, 2) == "\\u") {
+                        pos_ += 2;
+                        const auto low = hex4();
+                        if (!low.has_value() || *low < 0xDC00 || *low >= 0xE000) {
+                            return std::nullopt;
+                        }
+                        c32 = 0x10000 + ((*c32 - 0xD800) << 10) + (*low - 0xDC00);
+                    }
+                    if (!c32.has_value()) {
+                        return std::nullopt;
+                    }
+                    encode_utf8(std::u32string_view{&*c32, 1}, out);
+                    break;
+                }
+                default: out += escaped; break;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<int64_t> integer() {
+        skip_space();
+        int64_t value = 0;
+        const auto [end, ec] = std::from_chars(text_.data() + pos_, text_.data() + text_.size(), value);
+        if (ec != std::errc{}) {
+            return std::nullopt;
+        }
+        pos_ = static_cast<size_t>(end - text_.data());
+        return value;
+    }
+
+    bool skip_value() {
+        skip_space();
+        if (pos_ == text_.size()) {
+            return false;
+        }
+        switch (text_[pos_]) {
+            case '"': return string().has_value();
+            case '{': return object([&](std::string_view) { return skip_value(); });
+            case '[': return array([&] { return skip_value(); });
+            default: break;
+        }
+        // A number or a literal: everything up to the next delimiter.
+        const size_t end = text_.find_first_of(",]} \t", pos_);
+        const bool any = end != pos_;
+        pos_ = end == std::string_view::npos ? text_.size() : end;
+        return any;
+    }
+
+private:
+    void skip_space() {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t')) {
+            ++pos_;
+        }
+    }
+
+    bool consume(const char c) {
+        skip_space();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<char32_t> hex4() {
+        uint32_t value = 0;
+        if (text_.size() - pos_ < 4 ||
+            std::from_chars(text_.data() + pos_, text_.data() + pos_ + 4, value, 16).ptr != text_.data() + pos_ + 4) {
+            return std::nullopt;
+        }
+        pos_ += 4;
+        return static_cast<char32_t>(value);
+    }
+
+    std::string_view text_;
+    size_t pos_ = 0;
+};
+
+struct ScriptSession {
+    LessonType type = LessonType::Random;
+    std::optional<std::string> word;
+    std::vector<std::string> answers;
+};
+
+std::optional<ScriptSession> parse_session(const std::string_view line) {
+    ScriptSession session;
+    JsonReader json{line};
+    const bool parsed = json.object([&](const std::string_view key) {
+        if (key == "type") {
+            const auto type = json.integer();
+            if (!type.has_value() || *type < 0 || *type > 3) {
+                return false;
+            }
+            session.type = static_cast<LessonType>(*type);
+            return true;
+        }
+        if (key == "word") {
+            session.word = json.string();
+            return session.word.has_value();
+        }
+        if (key == "answers") {
+            return json.array([&] {
+                auto answer = json.string();
+                if (answer.has_value()) {
+                    session.answers.push_back(std::move(answer.value()));
+                }
+                return answer.has_value();
+            });
+        }
+        return json.skip_value();
+    });
+    if (!parsed || !json.at_end()) {
+        return std::nullopt;
+    }
+    return session;
+}
+
+struct BatchStats {
+    LatencyHistogram starts;
+    LatencyHistogram answers;
+    size_t solved = 0;
+    size_t failed = 0;
+    size_t unfinished = 0;
+};
+
+// One lesson at a time on a reused engine, timing every call into it.
+class BatchPlayer {
+public:
+    BatchPlayer(const Deck &deck, const BatchOptions &options, const uint64_t seed)
+        : deck_(deck), options_(options), engine_(options.near_miss), rng_(seed) {}
+
+    void start(const LessonType type, const size_t row) {
+        const LessonType resolved = resolve_lesson_type(type != LessonType::Random ? type : options_.lesson_type,
+                                                        rng_);
+        const auto begin = Clock::now();
+        engine_.start(resolved, deck_.lessons[row], rng_,
+                      resolved == LessonType::MultipleChoice ? deck_distractors(deck_, row, rng_) : Distractors{});
+        stats_.starts.record(Clock::now() - begin);
+        playing_ = true;
+    }
+
+    void start_random(const LessonType type) {
+        start(type, std::uniform_int_distribution<size_t>{0, deck_.lessons.size() - 1}(rng_));
+    }
+
+    // Returns whether the lesson is still going on.
+    bool submit(const std::string_view answer) {
+        const auto begin = Clock::now();
+        const LessonStatus status = engine_.submit(answer).status;
+        stats_.answers.record(Clock::now() - begin);
+        if (status == LessonStatus::InProgress) {
+            return true;
+        }
+        ++(status == LessonStatus::Solved ? stats_.solved : stats_.failed);
+        playing_ = false;
+        return false;
+    }
+
+    // Counts a lesson the script stopped answering.
+    void abandon() {
+        if (playing_) {
+            ++stats_.unfinished;
+            playing_ = false;
+        }
+    }
+
+    [[nodiscard]] bool playing() const { return playing_; }
+    [[nodiscard]] const BatchStats &stats() const { return stats_; }
+
+private:
+    const Deck &deck_;
+    const BatchOptions &options_;
+    LessonEngine engine_;
+    Rng rng_;
+    BatchStats stats_;
+    bool playing_ = false;
+};
+
+} // namespace
+
+int run_batch(const Deck &deck, std::istream &script, const BatchOptions &options) {
+    // The script is read up front, so that reading it is not timed and
+    // --repeat plays it again from memory.
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(script, line);) {
+        if (line.ends_with('\r')) {
+            line.pop_back();
+        }
+        lines.push_back(std::move(line));
+    }
+    const auto first = std::ranges::find_if(lines, [](const std::string &line) { return !line.empty(); });
+    const bool jsonl = first != lines.end() && first->starts_with('{');
+
+    // Sessions are checked before anything is played.
+    std::vector<std::pair<ScriptSession, std::optional<size_t>>> sessions;
+    if (jsonl) {
+        std::unordered_map<std::string_view, size_t> rows_by_word;
+        for (size_t row = deck.lessons.size(); row-- > 0;) {
+            rows_by_word[deck.lessons[row].word] = row;
+        }
+        for (size_t i = 0; i < lines.size(); ++i) {
+            if (lines[i].empty()) {
+                continue;
+            }
+            auto session = parse_session(lines[i]);
+            if (!session.has_value()) {
+                std::println(std::cerr, "Error: line {}: not a session object.", i + 1);
+                continue;
+            }
+            std::optional<size_t> row;
+            if (session->word.has_value()) {
+                const auto it = rows_by_word.find(session->word.value());
+                if (it == rows_by_word.end()) {
+                    std::println(std::cerr, "Error: line {}: \"{}\" is not a word of the deck.", i + 1,
+                                 session->word.value());
+                    continue;
+                }
+                row = it->second;
+            }
+            sessions.emplace_back(std::move(session.value()), row);
+        }
+    }
+
+    const uint64_t seed = options.seed.value_or(random_seed());
+    BatchPlayer player{deck, options, seed};
+    const auto begin = Clock::now();
+    for (size_t round = 0; round < options.repeat; ++round) {
+        if (jsonl) {
+            for (const auto &[session, row] : sessions) {
+                if (row.has_value()) {
+                    player.start(session.type, row.value());
+                } else {
+                    player.start_random(session.type);
+                }
+                for (const std::string &answer : session.answers) {
+                    if (!player.submit(answer)) {
+                        break;
+                    }
+                }
+                player.abandon();
+            }
+        } else {
+            for (const std::string &answer : lines) {
+                if (!player.playing()) {
+                    player.start_random(LessonType::Random);
+                }
+                player.submit(answer);
+            }
+            player.abandon();
+        }
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - begin;
+
+    const BatchStats &stats = player.stats();
+    const size_t lessons = stats.solved + stats.failed + stats.unfinished;
+    std::println("Played {} lessons ({} solved, {} failed, {} unfinished) with {} answers in {:.3f} s: "
+                 "{:.0f} answers/s, {:.0f} lessons/s (seed {}).",
+                 lessons, stats.solved, stats.failed, stats.unfinished, stats.answers.count(), elapsed.count(),
+                 static_cast<double>(stats.answers.count()) / elapsed.count(),
+                 static_cast<double>(lessons) / elapsed.count(), seed);
+    stats.starts.print("Lesson start");
+    stats.answers.print("Answer");
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef LEARNMON_BATCH_H
+#define LEARNMON_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+
+#include "deck.h"
+#include "lesson.h"
+
+struct BatchOptions {
+    LessonType lesson_type = LessonType::Random; // for lessons the script leaves open
+    size_t near_miss = 0;
+    size_t repeat = 1; // plays the whole script this many times
+    std::optional<uint64_t> seed; // random if unset; printed with the results
+};
+
+// Drives the lesson engines from a script instead of a learner, with no
+// screens and no waits, and prints per-answer latency histograms and the
+// throughput to stdout. The script is either
+//   - plain text: every line is an answer, fed to lessons on random rows
+//     like a server session, a new lesson starting when one ends; or
+//   - JSON Lines, recognised by a first line starting with '{': one session
+//     per line, {"type": 1, "word": "...", "answers": ["...", ...]}, where
+//     "type" (a lesson type) and "word" (a word of the deck) are optional.
+// Lines that cannot be played are reported on std::cerr and skipped.
+// Returns the process exit code.
+int run_batch(const Deck &deck, std::istream &script, const BatchOptions &options);
+
+#endif //LEARNMON_BATCH_H
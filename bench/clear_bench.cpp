@@ -0,0 +1,92 @@
+// Compares ways of drawing the terminal frontend's screens, all to /dev/null:
+// a refresh (clear, then a hangman screen) with system("clear") and stdio
+// lines flushed one by one as on a line-buffered terminal, and with a Screen
+// written at once; then a long recap printed both ways. TERM is set so that
+// `clear` does its full work.
+// Usage: LearnMon_clear_bench [system refreshes] [screen refreshes] [recap lines]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <print>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "terminal.h"
+
+namespace {
+
+template<typename F>
+double time_ms(F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+constexpr std::string_view recap_line = "Сайн байна уу? (Sain baina uu?)- Hello (formal)";
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t system_refreshes = argc >= 2 ? std::stoull(argv[1]) : 200;
+    const size_t screen_refreshes = argc >= 3 ? std::stoull(argv[2]) : 100'000;
+    const size_t recap_lines = argc >= 4 ? std::stoull(argv[3]) : 100'000;
+
+    setenv("TERM", "xterm-256color", 0);
+    const int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd < 0 || std::freopen("/dev/null", "w", stdout) == nullptr) {
+        std::println(stderr, "Error: cannot open /dev/null.");
+        return EXIT_FAILURE;
+    }
+
+    const double system_ms = time_ms([&] {
+        for (size_t i = 0; i < system_refreshes; ++i) {
+            [[maybe_unused]] const int status = std::system("clear");
+            for (const std::string_view line : {"", "Guess the word!", " Current: с__н б__н_ уу?",
+                                                "Enter a letter or a full word:"}) {
+                std::println("{}", line);
+                std::fflush(stdout);
+            }
+        }
+    });
+
+    Screen screen{Terminal{true}, null_fd};
+    const double screen_ms = time_ms([&] {
+        for (size_t i = 0; i < screen_refreshes; ++i) {
+            screen.clear();
+            screen.println("\nGuess the word!\n Current: {}", "с__н б__н_ уу?");
+            screen.println("Enter a letter or a full word:");
+            screen.flush();
+        }
+    });
+
+    const double lines_ms = time_ms([&] {
+        for (size_t i = 0; i < recap_lines; ++i) {
+            std::println("{}", recap_line);
+            std::fflush(stdout);
+        }
+    });
+
+    // Not a terminal as far as the pager knows, so the whole recap goes out
+    // in flush_threshold chunks.
+    Screen recap{Terminal{false}, null_fd};
+    const double recap_ms = time_ms([&] {
+        page(recap, std::cin, recap_lines, [](Screen &out, size_t) { out.println("{}", recap_line); });
+        recap.flush();
+    });
+    close(null_fd);
+
+    const double system_us = system_ms * 1e3 / static_cast<double>(system_refreshes);
+    const double screen_us = screen_ms * 1e3 / static_cast<double>(screen_refreshes);
+    std::println(stderr, "refresh, system(\"clear\") + stdio lines: {:10.2f} us", system_us);
+    std::println(stderr, "refresh, Screen:                        {:10.2f} us ({:.0f}x faster)", screen_us,
+                 system_us / screen_us);
+    std::println(stderr, "{} recap lines, flushed per line:   {:8.1f} ms", recap_lines, lines_ms);
+    std::println(stderr, "{} recap lines, Screen:             {:8.1f} ms ({:.0f}x faster)", recap_lines, recap_ms,
+                 lines_ms / recap_ms);
+    return EXIT_SUCCESS;
+}
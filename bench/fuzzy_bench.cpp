@@ -0,0 +1,100 @@
+// Times near-miss scoring of spelling answers: every prefix of a mistyped
+// answer is scored, as a frontend would on each keystroke, with the
+// bit-parallel matcher and with the banded dynamic-programming distance.
+// The deck is small and scored `rounds` times, so that the words stay in
+// cache as a lesson's word does.
+// Usage: LearnMon_fuzzy_bench [rows] [max distance] [rounds]
+
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "deck.h"
+#include "fuzzy_match.h"
+#include "rng.h"
+#include "similar_words.h"
+#include "synthetic_deck.h"
+
+namespace {
+
+template<typename F>
+double time_ms(F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// `word` with one or two letters replaced, as a learner might type it.
+std::u32string mistype(const std::u32string_view word, Rng &rng) {
+    std::u32string answer{word};
+    const size_t typos = std::uniform_int_distribution<size_t>{1, 2}(rng);
+    for (size_t k = 0; k < typos && !answer.empty(); ++k) {
+        answer[std::uniform_int_distribution<size_t>{0, answer.size() - 1}(rng)] = U'ж';
+    }
+    return answer;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t rows = argc >= 2 ? std::stoull(argv[1]) : 1'000;
+    const size_t limit = argc >= 3 ? std::stoull(argv[2]) : 2;
+    const size_t rounds = argc >= 4 ? std::stoull(argv[3]) : 1'000;
+
+    const Deck deck = load_deck(random_word_deck_path(rows), std::nullopt);
+    Rng rng{11};
+    std::vector<std::u32string> answers;
+    answers.reserve(deck.lessons.size());
+    size_t keystrokes = 0;
+    for (size_t row = 0; row < deck.lessons.size(); ++row) {
+        answers.push_back(mistype(deck.lessons.folded_word_chars(row), rng));
+        keystrokes += answers.back().size();
+    }
+
+    // A lesson builds its matcher once, when it starts.
+    std::vector<FuzzyMatcher> matchers;
+    matchers.reserve(deck.lessons.size());
+    const double build_ms = time_ms([&] {
+        for (size_t row = 0; row < deck.lessons.size(); ++row) {
+            matchers.emplace_back(deck.lessons.folded_word_chars(row));
+        }
+    });
+
+    size_t accepted_fuzzy = 0;
+    const double fuzzy_ms = time_ms([&] {
+        for (size_t round = 0; round < rounds; ++round) {
+            for (size_t row = 0; row < answers.size(); ++row) {
+                const std::u32string_view answer = answers[row];
+                for (size_t typed = 1; typed <= answer.size(); ++typed) {
+                    accepted_fuzzy += matchers[row].distance(answer.substr(0, typed), limit) <= limit ? 1 : 0;
+                }
+            }
+        }
+    });
+
+    size_t accepted_banded = 0;
+    const double banded_ms = time_ms([&] {
+        for (size_t round = 0; round < rounds; ++round) {
+            for (size_t row = 0; row < answers.size(); ++row) {
+                const std::u32string_view word = deck.lessons.folded_word_chars(row);
+                const std::u32string_view answer = answers[row];
+                for (size_t typed = 1; typed <= answer.size(); ++typed) {
+                    accepted_banded += bounded_edit_distance(answer.substr(0, typed), word, limit) <= limit ? 1 : 0;
+                }
+            }
+        }
+    });
+
+    const auto per_keystroke = [&](const double ms) { return ms * 1e6 / static_cast<double>(keystrokes * rounds); };
+    std::println("{} answers, {} keystrokes, within {} edits:", answers.size(), keystrokes, limit);
+    std::println("  bit-parallel: {:8.1f} ns/keystroke ({} accepted) + {:.1f} ns per word to build the matcher",
+                 per_keystroke(fuzzy_ms), accepted_fuzzy / rounds,
+                 build_ms * 1e6 / static_cast<double>(answers.size()));
+    std::println("  banded DP:    {:8.1f} ns/keystroke ({} accepted, transpositions count as one edit)",
+                 per_keystroke(banded_ms), accepted_banded / rounds);
+    return EXIT_SUCCESS;
+}
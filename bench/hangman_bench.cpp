@@ -0,0 +1,145 @@
+// Plays hangman on long phrases with the previous string-rebuilding loop and
+// with HangmanGame, guessing every letter of the alphabet plus a few misses.
+// Both render the board once per guess, as the CLI does; HangmanGame is also
+// timed without rendering, which leaves only the guesses themselves.
+// Usage: LearnMon_hangman_bench [max phrase length]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <string>
+#include <vector>
+
+#include "case_fold.h"
+#include "hangman.h"
+#include "lesson.h"
+#include "rng.h"
+#include "utf8.h"
+
+namespace {
+
+template<typename F>
+double time_ms(F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Words from mong.csv joined with spaces until the phrase has `length` codepoints.
+std::string make_phrase(const size_t length) {
+    constexpr std::array<std::u32string_view, 6> words = {U"Сайн", U"байна", U"уу", U"Өглөөний", U"мэнд",
+                                                          U"Баярлалаа"};
+    std::u32string phrase;
+    for (size_t i = 0; phrase.size() < length; ++i) {
+        if (!phrase.empty()) {
+            phrase += U' ';
+        }
+        phrase += words[i % words.size()];
+    }
+    phrase.resize(length);
+    return encode_utf8(phrase);
+}
+
+// The guess order: every folded letter of the alphabet plus some misses, shuffled.
+std::vector<std::string> make_guesses() {
+    std::u32string letters = U"абвгдеёжзийклмноөпрстуүфхцчшщъыьэюяqxz";
+    std::ranges::shuffle(letters, Rng{42});
+    std::vector<std::string> guesses;
+    for (const char32_t letter : letters) {
+        guesses.push_back(encode_utf8(std::u32string_view{&letter, 1}));
+    }
+    return guesses;
+}
+
+// The loop serve_hangman_lesson used before HangmanGame: the board is a vector
+// of one-character strings, joined again for every check and render, and every
+// guess scans the whole word.
+size_t play_rebuilding(const std::string &word, const std::vector<std::string> &guesses) {
+    const std::vector<std::string> target_chars = split_word_to_chars(word);
+    std::vector<std::string> guess_chars(target_chars.size(), "_");
+    for (size_t i = 0; i < target_chars.size(); ++i) {
+        if (target_chars[i] == " ") {
+            guess_chars[i] = " ";
+        }
+    }
+    const auto get_guess_string = [&] {
+        std::string s;
+        for (const auto &c : guess_chars) {
+            s += c;
+        }
+        return s;
+    };
+
+    size_t rendered = 0;
+    for (const std::string &guess : guesses) {
+        if (!get_guess_string().contains('_')) {
+            break;
+        }
+        rendered += get_guess_string().size();
+        for (size_t i = 0; i < target_chars.size(); ++i) {
+            if (target_chars[i] == guess) {
+                guess_chars[i] = guess;
+            }
+        }
+        if (!get_guess_string().contains("_")) {
+            break;
+        }
+    }
+    return rendered;
+}
+
+size_t play_incremental(const LessonView &lesson, const std::vector<std::string> &guesses, const bool render) {
+    HangmanGame game{lesson};
+    size_t rendered = 0;
+    for (const std::string &guess : guesses) {
+        if (game.solved()) {
+            break;
+        }
+        if (render) {
+            rendered += encode_utf8(game.revealed()).size();
+        }
+        const std::u32string letter = fold_case(decode_utf8(guess));
+        game.guess_letter(letter.front());
+    }
+    return rendered;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t max_length = argc >= 2 ? std::stoull(argv[1]) : 100'000;
+    const std::vector<std::string> guesses = make_guesses();
+
+    for (size_t length = 10; length <= max_length; length *= 10) {
+        // Lowercase phrase, so both loops reveal the same letters.
+        const LessonEntry entry{1, encode_utf8(fold_case(decode_utf8(make_phrase(length)))), "", ""};
+        const size_t rounds = std::max<size_t>(1, 1'000'000 / length);
+
+        size_t rebuilt = 0;
+        const double rebuild_ms = time_ms([&] {
+            for (size_t i = 0; i < rounds; ++i) {
+                rebuilt += play_rebuilding(entry.word, guesses);
+            }
+        });
+        size_t incremental = 0;
+        const double incremental_ms = time_ms([&] {
+            for (size_t i = 0; i < rounds; ++i) {
+                incremental += play_incremental(entry.view(), guesses, true);
+            }
+        });
+        const double guesses_ms = time_ms([&] {
+            for (size_t i = 0; i < rounds; ++i) {
+                play_incremental(entry.view(), guesses, false);
+            }
+        });
+
+        const auto per_game = [&](const double ms) { return ms / static_cast<double>(rounds); };
+        std::println("{:>7} chars: rebuilding {:>9.3f} ms/game, HangmanGame {:>9.3f} ms/game ({:.1f}x), "
+                     "without rendering {:>9.3f} ms/game{}",
+                     length, per_game(rebuild_ms), per_game(incremental_ms), rebuild_ms / incremental_ms,
+                     per_game(guesses_ms), rebuilt == incremental ? "" : "  (boards differ!)");
+    }
+    return EXIT_SUCCESS;
+}
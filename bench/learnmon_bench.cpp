@@ -0,0 +1,194 @@
+// Google Benchmark suite over the hot paths of a lesson: loading a deck,
+// splitting lines and words, building a multiple-choice question with its
+// distractors, shuffling rows and guessing letters in hangman. Decks are the
+// synthetic ones of the other benches, 1k to 10M rows, generated in the temp
+// directory on first use. Unlike the standalone benches, results can be saved
+// as JSON and compared between builds with the library's tools/compare.py.
+// Usage: LearnMon_bench [--benchmark_filter=regex] [--benchmark_format=json]
+//                       [--benchmark_out=results.json --benchmark_out_format=json]
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "deck.h"
+#include "hangman.h"
+#include "lesson.h"
+#include "lesson_engine.h"
+#include "rng.h"
+#include "synthetic_deck.h"
+#include "utf8.h"
+
+namespace {
+
+constexpr int64_t min_rows = 1'000;
+constexpr int64_t max_rows = 10'000'000;
+
+// Random-word decks, loaded with their similar-word index once per size and
+// kept for the whole run: building the index is not what is measured.
+const Deck &similar_word_deck(const size_t rows) {
+    static std::map<size_t, std::unique_ptr<Deck>> decks;
+    auto &deck = decks[rows];
+    if (!deck) {
+        deck = std::make_unique<Deck>(load_deck(random_word_deck_path(rows), std::nullopt));
+        deck->similar_words = SimilarWords{deck->lessons};
+    }
+    return *deck;
+}
+
+std::vector<std::string> read_lines(const std::filesystem::path &path) {
+    std::ifstream in{path, std::ios::binary};
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+void BM_read_lesson_from_file(benchmark::State &state) {
+    const auto path = synthetic_deck_path(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        LoadReport report;
+        auto lessons = read_lesson_from_file(path, std::nullopt, report);
+        benchmark::DoNotOptimize(lessons.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size(path)));
+}
+BENCHMARK(BM_read_lesson_from_file)->RangeMultiplier(10)->Range(min_rows, max_rows)->Unit(benchmark::kMillisecond);
+
+// The mapped, multi-threaded loader the CLI actually uses, for comparison.
+void BM_load_deck(benchmark::State &state) {
+    const auto path = synthetic_deck_path(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        const Deck deck = load_deck(path, std::nullopt);
+        benchmark::DoNotOptimize(deck.lessons.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size(path)));
+}
+BENCHMARK(BM_load_deck)->RangeMultiplier(10)->Range(min_rows, max_rows)->Unit(benchmark::kMillisecond);
+
+void BM_split(benchmark::State &state) {
+    const std::vector<std::string> lines = read_lines(synthetic_deck_path(static_cast<size_t>(state.range(0))));
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        for (const std::string &line : lines) {
+            auto fields = split(line, ';');
+            benchmark::DoNotOptimize(fields.data());
+            bytes += static_cast<int64_t>(line.size());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(lines.size()));
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_split)->RangeMultiplier(10)->Range(min_rows, max_rows)->Unit(benchmark::kMillisecond);
+
+void BM_split_word_to_chars(benchmark::State &state) {
+    const auto lessons = read_lesson_from_file(synthetic_deck_path(static_cast<size_t>(state.range(0))), std::nullopt);
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        for (const LessonEntry &lesson : lessons) {
+            auto chars = split_word_to_chars(lesson.word);
+            benchmark::DoNotOptimize(chars.data());
+            bytes += static_cast<int64_t>(lesson.word.size());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(lessons.size()));
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_split_word_to_chars)->RangeMultiplier(10)->Range(min_rows, max_rows)->Unit(benchmark::kMillisecond);
+
+// A multiple-choice question with all three distractors generated by
+// make_distractors, as for CSV decks without --similar.
+void BM_generated_distractors(benchmark::State &state) {
+    const auto lessons = read_lesson_from_file(synthetic_deck_path(static_cast<size_t>(state.range(0))), std::nullopt);
+    Rng rng{42};
+    size_t row = 0;
+    for (auto _ : state) {
+        MultipleChoiceLesson lesson{lessons[row].view(), rng};
+        benchmark::DoNotOptimize(lesson);
+        row = (row + 1) % lessons.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_generated_distractors)->RangeMultiplier(10)->Range(min_rows, max_rows);
+
+// The same question with distractors looked up among similar deck words. The
+// number of candidates checked is capped, so the time levels off on large decks.
+void BM_similar_distractors(benchmark::State &state) {
+    const Deck &deck = similar_word_deck(static_cast<size_t>(state.range(0)));
+    Rng rng{42};
+    std::uniform_int_distribution<size_t> pick(0, deck.lessons.size() - 1);
+    for (auto _ : state) {
+        const size_t row = pick(rng);
+        MultipleChoiceLesson lesson{deck.lessons[row], rng, deck_distractors(deck, row, rng)};
+        benchmark::DoNotOptimize(lesson);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_similar_distractors)->RangeMultiplier(10)->Range(min_rows, 1'000'000);
+
+// Shuffling the row numbers of a deck, as --sample and the review order do,
+// with the standard library's default engine and with Rng.
+template<typename Engine>
+void BM_shuffle_rows(benchmark::State &state) {
+    std::vector<uint32_t> order(static_cast<size_t>(state.range(0)));
+    std::iota(order.begin(), order.end(), 0);
+    Engine rng{42};
+    for (auto _ : state) {
+        std::ranges::shuffle(order, rng);
+        benchmark::DoNotOptimize(order.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_shuffle_rows<std::default_random_engine>)->RangeMultiplier(10)->Range(min_rows, max_rows);
+BENCHMARK(BM_shuffle_rows<Rng>)->RangeMultiplier(10)->Range(min_rows, max_rows);
+
+// Whole hangman games on phrases of range(0) letters: every letter of the
+// alphabet plus a few misses is guessed, in a fixed shuffled order, until the
+// phrase is solved. Items are guesses.
+void BM_hangman_guess(benchmark::State &state) {
+    constexpr std::u32string_view words[] = {U"сайн", U"байна", U"уу", U"өглөөний", U"мэнд", U"баярлалаа"};
+    std::u32string phrase;
+    for (size_t i = 0; phrase.size() < static_cast<size_t>(state.range(0)); ++i) {
+        if (!phrase.empty()) {
+            phrase += U' ';
+        }
+        phrase += words[i % std::size(words)];
+    }
+    phrase.resize(static_cast<size_t>(state.range(0)));
+    const LessonEntry entry{1, encode_utf8(phrase), "", ""};
+
+    std::u32string guesses = U"абвгдеёжзийклмноөпрстуүфхцчшщъыьэюяqxz";
+    std::ranges::shuffle(guesses, Rng{42});
+
+    int64_t guessed = 0;
+    for (auto _ : state) {
+        HangmanGame game{entry.view()};
+        for (const char32_t letter : guesses) {
+            if (game.solved()) {
+                break;
+            }
+            benchmark::DoNotOptimize(game.guess_letter(letter));
+            ++guessed;
+        }
+    }
+    state.SetItemsProcessed(guessed);
+}
+BENCHMARK(BM_hangman_guess)->RangeMultiplier(10)->Range(10, 100'000);
+
+} // namespace
+
+BENCHMARK_MAIN();
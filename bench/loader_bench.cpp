@@ -0,0 +1,96 @@
+// Compares the getline-based read_lesson_from_file against the mmap loader and
+// times each delimiter scanner and UTF-8 validator kernel.
+// Usage: LearnMon_loader_bench [rows] [deck.csv]
+
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "compiled_deck.h"
+#include "csv_scanner.h"
+#include "deck.h"
+#include "lesson.h"
+#include "synthetic_deck.h"
+#include "utf8.h"
+
+namespace {
+
+template<typename F>
+double time_ms(F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t rows = argc >= 2 ? std::stoull(argv[1]) : 10'000'000;
+    const std::filesystem::path path = argc >= 3 ? std::filesystem::path{argv[2]} : synthetic_deck_path(rows);
+    std::println("Deck: {} ({} bytes)", path.string(), std::filesystem::file_size(path));
+
+    size_t getline_rows = 0;
+    const double getline_ms = time_ms([&] { getline_rows = read_lesson_from_file(path, std::nullopt).size(); });
+    std::println("read_lesson_from_file: {:>10} rows {:>10.1f} ms", getline_rows, getline_ms);
+
+    size_t single_rows = 0;
+    const double single_ms = time_ms([&] { single_rows = load_deck(path, std::nullopt, 1).lessons.size(); });
+    std::println("load_deck (1 thread):  {:>10} rows {:>10.1f} ms", single_rows, single_ms);
+
+    size_t mmap_rows = 0;
+    const double mmap_ms = time_ms([&] { mmap_rows = load_deck(path, std::nullopt).lessons.size(); });
+    std::println("load_deck ({:>2} threads): {:>8} rows {:>10.1f} ms", std::thread::hardware_concurrency(), mmap_rows,
+                 mmap_ms);
+
+    size_t filtered_rows = 0;
+    const double filtered_ms = time_ms([&] { filtered_rows = load_deck(path, 37).lessons.size(); });
+    std::println("load_deck (lesson 37): {:>10} rows {:>10.1f} ms", filtered_rows, filtered_ms);
+
+    std::println("Speedup: {:.2f}x", getline_ms / mmap_ms);
+
+    const auto lmb_path = std::filesystem::path{path}.replace_extension(".lmb");
+    const double compile_ms = time_ms([&] { write_compiled_deck(load_deck(path, std::nullopt), lmb_path); });
+    std::println("compile to .lmb:       {:>10} bytes {:>9.1f} ms", std::filesystem::file_size(lmb_path), compile_ms);
+
+    size_t lmb_rows = 0;
+    const double lmb_ms = time_ms([&] { lmb_rows = open_deck(lmb_path, std::nullopt).lessons.size(); });
+    std::println("open_deck (.lmb):      {:>10} rows {:>10.1f} ms", lmb_rows, lmb_ms);
+
+    size_t lmb_lesson_rows = 0;
+    const double lmb_lesson_ms = time_ms([&] { lmb_lesson_rows = open_deck(lmb_path, 37).lessons.size(); });
+    std::println("open_deck (.lmb, 37):  {:>10} rows {:>10.1f} ms", lmb_lesson_rows, lmb_lesson_ms);
+
+    const auto mapped = MappedFile::open(path);
+    if (!mapped.has_value()) {
+        return EXIT_FAILURE;
+    }
+    const std::string_view text = mapped->view();
+    constexpr size_t block_size = size_t{1} << 20;
+    std::vector<uint32_t> offsets(block_size);
+    for (const ScanKernel kernel : {ScanKernel::Scalar, ScanKernel::Sse2, ScanKernel::Avx2}) {
+        if (kernel > detect_scan_kernel()) {
+            continue;
+        }
+        size_t delimiters = 0;
+        const double scan_ms = time_ms([&] {
+            for (size_t i = 0; i < text.size(); i += block_size) {
+                delimiters += scan_delimiters(text.substr(i, block_size), offsets, kernel);
+            }
+        });
+        std::println("scan_delimiters ({:<6}): {:>10} hits {:>10.1f} ms", scan_kernel_name(kernel), delimiters, scan_ms);
+    }
+    for (const ScanKernel kernel : {ScanKernel::Scalar, ScanKernel::Avx2}) {
+        if (kernel > detect_scan_kernel()) {
+            continue;
+        }
+        std::expected<void, size_t> checked;
+        const double validate_ms = time_ms([&] { checked = validate_utf8(text, kernel); });
+        std::println("validate_utf8   ({:<6}): {:>10} valid {:>9.1f} ms", scan_kernel_name(kernel),
+                     checked.has_value() ? text.size() : checked.error(), validate_ms);
+    }
+    return getline_rows == mmap_rows && single_rows == mmap_rows && lmb_rows == mmap_rows ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,98 @@
+// Times the spaced-repetition scheduler on a million cards, held by one user
+// or spread over many: queueing the cards, replaying a review log written to
+// disk, and taking and reviewing due cards one at a time.
+// Usage: LearnMon_scheduler_bench [cards] [users] [log records]
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <print>
+#include <string>
+#include <vector>
+
+#include "review_log.h"
+#include "rng.h"
+#include "scheduler.h"
+
+namespace {
+
+template<typename F>
+double time_ms(F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void run(const size_t cards, const uint32_t users, const size_t log_records) {
+    constexpr int64_t start_time = 1'700'000'000;
+    const size_t cards_per_user = cards / users;
+
+    Scheduler scheduler;
+    const double add_ms = time_ms([&] {
+        for (uint32_t user = 0; user < users; ++user) {
+            for (uint64_t card = 0; card < cards_per_user; ++card) {
+                scheduler.add(user, card, start_time);
+            }
+        }
+    });
+
+    // A log of past reviews, spread over the users and a month.
+    const auto path = std::filesystem::temp_directory_path() / "learnmon_bench.lmr";
+    std::filesystem::remove(path);
+    Rng rng{5};
+    auto log = ReviewLog::open(path);
+    const double append_ms = time_ms([&] {
+        for (size_t i = 0; i < log_records; ++i) {
+            ReviewRecord record;
+            record.reviewed_at = start_time - 30 * 86'400 + static_cast<int64_t>(i * 30 * 86'400 / log_records);
+            record.user = static_cast<uint32_t>(rng() % users);
+            record.card = rng() % cards_per_user;
+            record.grade = rng() % 4 == 0 ? grade_failed : grade_solved;
+            log->append(record);
+        }
+    });
+
+    std::vector<ReviewRecord> records;
+    const double read_ms = time_ms([&] { records = read_review_log(path).value(); });
+    const double replay_ms = time_ms([&] { scheduler.replay(records); });
+    std::filesystem::remove(path);
+
+    // Sessions: take the next due card of a random user and review it.
+    constexpr size_t steps = 100'000;
+    size_t taken = 0;
+    const double session_ms = time_ms([&] {
+        for (size_t i = 0; i < steps; ++i) {
+            const auto user = static_cast<uint32_t>(rng() % users);
+            if (const auto card = scheduler.take_due(user, start_time); card.has_value()) {
+                ReviewRecord record;
+                record.reviewed_at = start_time;
+                record.user = user;
+                record.card = card.value();
+                record.grade = grade_solved;
+                scheduler.review(record);
+                ++taken;
+            }
+        }
+    });
+
+    std::println("{} cards x {} users: add {:.0f} ns/card; log append {:.0f} ns/record, read {:.1f} ms, "
+                 "replay {:.0f} ns/record; take+review {:.0f} ns ({} of {} steps found a due card)",
+                 cards_per_user, users, add_ms * 1e6 / static_cast<double>(cards), append_ms * 1e6 / static_cast<double>(log_records),
+                 read_ms, replay_ms * 1e6 / static_cast<double>(log_records), session_ms * 1e6 / static_cast<double>(steps), taken,
+                 steps);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t cards = argc >= 2 ? std::stoull(argv[1]) : 1'000'000;
+    const size_t log_records = argc >= 4 ? std::stoull(argv[3]) : 1'000'000;
+    if (argc >= 3) {
+        run(cards, static_cast<uint32_t>(std::stoul(argv[2])), log_records);
+    } else {
+        run(cards, 1, log_records);
+        run(cards, 1'000, log_records);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+// Client harness for `LearnMon serve`. Opens many idle sessions that read the
+// recap and then sit waiting, and meanwhile plays through lessons on a few
+// active sessions, timing each line's round trip. Every lesson is ended with
+// "quit", so any lesson type and deck work. With the server's pid, its resident
+// memory is sampled before and after the idle sessions connect.
+// Usage: LearnMon_server_client host:port|unix-path [idle sessions] [active sessions] [lines per session]
+//                               [server pid]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <netdb.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// The server's prompts; a reply is complete when the text read so far ends with one.
+constexpr std::array<std::string_view, 6> prompts = {
+    "Press Enter to start the lesson...\n", "Your answer:\n", "Enter your choice (1-4):\n",
+    "Enter a letter or a full word:\n", "Press Enter to continue...\n", "Bye!\n"};
+
+int connect_to(const std::string &address) {
+    if (const size_t colon = address.rfind(':'); colon != std::string::npos && address.find('/') == std::string::npos) {
+        std::string host = address.substr(0, colon);
+        if (host.size() >= 2 && host.front() == '[') {
+            host = host.substr(1, host.size() - 2);
+        }
+        const std::string port = address.substr(colon + 1);
+        addrinfo hints{};
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *found = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &found) != 0) {
+            return -1;
+        }
+        int fd = -1;
+        for (const addrinfo *ai = found; ai != nullptr; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+            if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+                break;
+            }
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(found);
+        return fd;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, address.c_str(), sizeof(addr.sun_path) - 1);
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Reads until the text ends with a prompt. Returns false if the server hung up first.
+bool read_reply(const int fd, std::string &reply) {
+    reply.clear();
+    std::array<char, 4096> buffer{};
+    while (!std::ranges::any_of(prompts, [&](const std::string_view prompt) { return reply.ends_with(prompt); })) {
+        const ssize_t n = recv(fd, buffer.data(), buffer.size(), 0);
+        if (n <= 0) {
+            return false;
+        }
+        reply.append(buffer.data(), static_cast<size_t>(n));
+    }
+    return true;
+}
+
+bool send_line(const int fd, const std::string_view line) {
+    const std::string data = std::string{line} + '\n';
+    return send(fd, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size());
+}
+
+// Resident memory of a process in KiB, or 0 if unknown.
+size_t resident_kib(const std::string &pid) {
+    std::ifstream status{"/proc/" + pid + "/status"};
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("VmRSS:")) {
+            return std::strtoull(line.c_str() + 6, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+double percentile(std::vector<double> &samples, const double p) {
+    if (samples.empty()) {
+        return 0;
+    }
+    const auto k = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::ranges::nth_element(samples, samples.begin() + static_cast<std::ptrdiff_t>(k));
+    return samples[k];
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::println(stderr, "Usage: {} host:port|unix-path [idle sessions] [active sessions] [lines per session] "
+                     "[server pid]", argv[0]);
+        return 1;
+    }
+    const std::string address = argv[1];
+    const size_t idle_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10'000;
+    const size_t active_count = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 8;
+    const size_t line_count = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1'000;
+    const std::string pid = argc > 5 ? argv[5] : "";
+
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    const size_t rss_before = pid.empty() ? 0 : resident_kib(pid);
+
+    // Idle sessions: connect them all, then wait until each has its recap.
+    const auto connect_start = std::chrono::steady_clock::now();
+    std::vector<int> idle;
+    idle.reserve(idle_count);
+    std::string reply;
+    for (size_t i = 0; i < idle_count; ++i) {
+        const int fd = connect_to(address);
+        if (fd < 0) {
+            std::println(stderr, "Connection {} failed: {}", i, std::strerror(errno));
+            break;
+        }
+        idle.push_back(fd);
+    }
+    size_t greeted = 0;
+    for (const int fd : idle) {
+        greeted += read_reply(fd, reply) ? 1 : 0;
+    }
+    const double connect_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - connect_start).count();
+    std::println("{} idle sessions connected and greeted in {:.1f} ms", greeted, connect_ms);
+
+    if (!pid.empty()) {
+        const size_t rss_after = resident_kib(pid);
+        std::println("server RSS {} KiB -> {} KiB ({:.2f} KiB per idle session)", rss_before, rss_after,
+                     greeted == 0 ? 0.0 : static_cast<double>(rss_after - rss_before) / static_cast<double>(greeted));
+    }
+
+    // Active sessions take turns: Enter starts a lesson, "quit" ends it.
+    std::vector<int> active;
+    for (size_t i = 0; i < active_count; ++i) {
+        const int fd = connect_to(address);
+        if (fd < 0 || !read_reply(fd, reply)) {
+            std::println(stderr, "Active session {} failed to start.", i);
+            return 1;
+        }
+        active.push_back(fd);
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(active_count * line_count);
+    const auto play_start = std::chrono::steady_clock::now();
+    for (size_t line = 0; line < line_count && !active.empty(); ++line) {
+        for (size_t i = 0; i < active.size();) {
+            const auto start = std::chrono::steady_clock::now();
+            if (!send_line(active[i], line % 2 == 0 ? "" : "quit") || !read_reply(active[i], reply) ||
+                reply.ends_with("Bye!\n")) {
+                // Out of lessons: the session is over.
+                close(active[i]);
+                active.erase(active.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+            latencies.push_back(
+                std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            ++i;
+        }
+    }
+    const double play_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - play_start).count();
+
+    std::println("{} lines on {} active sessions: {:.0f} lines/s", latencies.size(), active_count,
+                 static_cast<double>(latencies.size()) / play_s);
+    std::println("round trip p50 {:.1f} us, p99 {:.1f} us, max {:.1f} us", percentile(latencies, 0.5),
+                 percentile(latencies, 0.99), percentile(latencies, 1.0));
+
+    for (const int fd : idle) {
+        close(fd);
+    }
+    for (const int fd : active) {
+        close(fd);
+    }
+    return 0;
+}
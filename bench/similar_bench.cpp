@@ -0,0 +1,84 @@
+// Builds the similar-word index over decks of random words and times lookups
+// of four distractors within two edits, against scanning every distinct word.
+// Usage: LearnMon_similar_bench [max rows]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "deck.h"
+#include "similar_words.h"
+#include "synthetic_deck.h"
+
+namespace {
+
+template<typename F>
+double time_ms(F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double percentile(std::vector<double> &samples, const double p) {
+    const auto k = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::ranges::nth_element(samples, samples.begin() + static_cast<std::ptrdiff_t>(k));
+    return samples[k];
+}
+
+// The same lookup by checking every row: what the index saves.
+size_t scan_all(const LessonStore &lessons, const size_t row, const size_t wanted) {
+    size_t found = 0;
+    for (size_t other = 0; other < lessons.size() && found < wanted; ++other) {
+        const size_t distance = bounded_edit_distance(lessons.folded_word_chars(row), lessons.folded_word_chars(other),
+                                                      SimilarWords::default_max_distance);
+        found += distance >= 1 && distance <= SimilarWords::default_max_distance ? 1 : 0;
+    }
+    return found;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t max_rows = argc >= 2 ? std::stoull(argv[1]) : 1'000'000;
+    constexpr size_t lookups = 10'000;
+    constexpr size_t scans = 20;
+
+    for (size_t rows = 10'000; rows <= max_rows; rows *= 10) {
+        const Deck deck = load_deck(random_word_deck_path(rows), std::nullopt);
+        SimilarWords index;
+        const double build_ms = time_ms([&] { index = SimilarWords{deck.lessons}; });
+
+        Rng rng{7};
+        std::uniform_int_distribution<size_t> pick(0, deck.lessons.size() - 1);
+        std::array<uint32_t, 4> out{};
+        std::vector<double> latencies;
+        latencies.reserve(lookups);
+        size_t full = 0;
+        for (size_t i = 0; i < lookups; ++i) {
+            const size_t row = pick(rng);
+            const auto start = std::chrono::steady_clock::now();
+            const size_t found = index.find(deck.lessons, row, out, rng);
+            latencies.push_back(
+                std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            full += found == out.size() ? 1 : 0;
+        }
+
+        const double scan_ms = time_ms([&] {
+            for (size_t i = 0; i < scans; ++i) {
+                scan_all(deck.lessons, pick(rng), out.size());
+            }
+        });
+
+        std::println("{:>8} rows: index built in {:>8.1f} ms ({:.1f} MiB); lookup p50 {:>6.1f} us, p99 {:>6.1f} us, "
+                     "max {:>7.1f} us; {:.1f}% found 4; full scan {:>8.3f} ms/lookup",
+                     rows, build_ms, static_cast<double>(index.memory_usage()) / (1 << 20),
+                     percentile(latencies, 0.5), percentile(latencies, 0.99), percentile(latencies, 1.0),
+                     100.0 * static_cast<double>(full) / lookups, scan_ms / scans);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+// Memory footprint and recap iteration time of the deck representations:
+// vector<LessonEntry> (read_lesson_from_file), vector<LessonView> (the
+// previous Deck layout) and LessonStore.
+// Usage: LearnMon_store_bench [rows] [deck.csv]
+
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <print>
+#include <string>
+#include <vector>
+
+#include "deck.h"
+#include "lesson.h"
+#include "synthetic_deck.h"
+
+namespace {
+
+template<typename F>
+double time_ms(F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Anonymous resident memory in bytes, or 0 where /proc is not available.
+size_t anonymous_rss() {
+    std::ifstream status{"/proc/self/status"};
+    std::string key;
+    while (status >> key) {
+        if (key == "RssAnon:") {
+            size_t kib = 0;
+            status >> kib;
+            return kib * 1024;
+        }
+        status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    return 0;
+}
+
+size_t string_heap_bytes(const std::string &s) {
+    static const size_t sso_capacity = std::string{}.capacity();
+    return s.capacity() > sso_capacity ? s.capacity() + 1 : 0;
+}
+
+// Formats every row like recap_lesson does, into a reused buffer instead of stdout.
+template<typename Rows>
+void recap_into_buffer(const Rows &rows, std::string &buffer) {
+    for (const auto &lesson : rows) {
+        buffer.clear();
+        std::format_to(std::back_inserter(buffer), "{} ({})- {}\n", lesson.word, lesson.description,
+                       lesson.origin_word);
+    }
+}
+
+void report(const std::string_view name, const size_t metadata_bytes, const size_t rss_bytes, const double recap_ms) {
+    std::println("{:<22} {:>10.1f} MiB computed {:>10.1f} MiB RssAnon {:>10.1f} ms recap", name,
+                 static_cast<double>(metadata_bytes) / (1 << 20), static_cast<double>(rss_bytes) / (1 << 20), recap_ms);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t rows = argc >= 2 ? std::stoull(argv[1]) : 10'000'000;
+    const std::filesystem::path path = argc >= 3 ? std::filesystem::path{argv[2]} : synthetic_deck_path(rows);
+    std::string buffer;
+    buffer.reserve(256);
+
+    {
+        const size_t rss_before = anonymous_rss();
+        const Deck deck = load_deck(path, std::nullopt);
+        const size_t rss = anonymous_rss() - rss_before;
+        const double recap_ms = time_ms([&] { recap_into_buffer(deck.lessons.views(), buffer); });
+        report("LessonStore", deck.lessons.memory_usage(), rss, recap_ms);
+
+        const size_t views_rss_before = anonymous_rss();
+        std::vector<LessonView> views;
+        views.reserve(deck.lessons.size());
+        for (const LessonView lesson : deck.lessons.views()) {
+            views.push_back(lesson);
+        }
+        const size_t views_rss = anonymous_rss() - views_rss_before;
+        const double views_recap_ms = time_ms([&] { recap_into_buffer(views, buffer); });
+        report("vector<LessonView>", views.capacity() * sizeof(LessonView), views_rss, views_recap_ms);
+    }
+
+    const size_t rss_before = anonymous_rss();
+    const std::vector<LessonEntry> entries = read_lesson_from_file(path, std::nullopt);
+    const size_t rss = anonymous_rss() - rss_before;
+    size_t entry_bytes = entries.capacity() * sizeof(LessonEntry);
+    for (const LessonEntry &entry : entries) {
+        entry_bytes += string_heap_bytes(entry.word) + string_heap_bytes(entry.description) +
+                       string_heap_bytes(entry.origin_word);
+    }
+    const double recap_ms = time_ms([&] {
+        for (const LessonEntry &entry : entries) {
+            buffer.clear();
+            std::format_to(std::back_inserter(buffer), "{} ({})- {}\n", entry.word, entry.description,
+                           entry.origin_word);
+        }
+    });
+    report("vector<LessonEntry>", entry_bytes, rss, recap_ms);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,82 @@
+#ifndef LEARNMON_SYNTHETIC_DECK_H
+#define LEARNMON_SYNTHETIC_DECK_H
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "rng.h"
+
+// Writes a mong.csv-style deck with `rows` lines cycling through lessons 1-255.
+inline void write_synthetic_deck(const std::filesystem::path &path, const size_t rows) {
+    constexpr std::array<std::string_view, 8> words = {
+        "Сайн байна уу?", "Өглөөний мэнд!", "Баярлалаа", "Уучлаарай",
+        "Би монгол хэл сурч байна", "Хэд вэ?", "Ном", "Гэр бүл"};
+    constexpr std::array<std::string_view, 8> descriptions = {
+        "Sain baina uu?", "Öglöönii mend!", "Bayarlalaa", "Uuchlaarai",
+        "Bi mongol khel surch baina", "Khed ve?", "Nom", "Ger bül"};
+    constexpr std::array<std::string_view, 8> origins = {
+        "Hello (formal)", "Good morning!", "Thank you", "Sorry",
+        "I am learning Mongolian", "How much?", "Book", "Family"};
+
+    std::ofstream out{path, std::ios::binary};
+    std::string line;
+    for (size_t i = 0; i < rows; ++i) {
+        const size_t k = i % words.size();
+        line.clear();
+        line += std::to_string(i * 255 / rows + 1);
+        line += ';';
+        line += words[k];
+        line += ';';
+        line += descriptions[k];
+        line += ';';
+        line += origins[k];
+        line += '\n';
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
+
+// Writes a deck of `rows` random Mongolian words of 3 to 12 letters, so that
+// nearly every row has its own word, unlike write_synthetic_deck's eight phrases.
+inline void write_random_word_deck(const std::filesystem::path &path, const size_t rows) {
+    constexpr std::array<std::string_view, 35> letters = {
+        "а", "б", "в", "г", "д", "е", "ё", "ж", "з", "и", "й", "к", "л", "м", "н", "о", "ө", "п",
+        "р", "с", "т", "у", "ү", "ф", "х", "ц", "ч", "ш", "щ", "ъ", "ы", "ь", "э", "ю", "я"};
+
+    std::ofstream out{path, std::ios::binary};
+    Rng rng{42};
+    std::string line;
+    for (size_t i = 0; i < rows; ++i) {
+        line.clear();
+        line += std::to_string(i * 255 / rows + 1);
+        line += ';';
+        const size_t length = 3 + rng() % 10;
+        for (size_t k = 0; k < length; ++k) {
+            line += letters[rng() % letters.size()];
+        }
+        line += ";desc;origin\n";
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
+
+inline std::filesystem::path random_word_deck_path(const size_t rows) {
+    auto path = std::filesystem::temp_directory_path() / ("learnmon_random_words_" + std::to_string(rows) + ".csv");
+    if (!std::filesystem::exists(path)) {
+        write_random_word_deck(path, rows);
+    }
+    return path;
+}
+
+// Returns a cached synthetic deck in the temp directory, generating it on first use.
+inline std::filesystem::path synthetic_deck_path(const size_t rows) {
+    auto path = std::filesystem::temp_directory_path() / ("learnmon_synthetic_" + std::to_string(rows) + ".csv");
+    if (!std::filesystem::exists(path)) {
+        write_synthetic_deck(path, rows);
+    }
+    return path;
+}
+
+#endif //LEARNMON_SYNTHETIC_DECK_H
@@ -0,0 +1,13 @@
+#include "case_fold.h"
+
+#include <algorithm>
+
+void fold_case(const std::u32string_view chars, const std::span<char32_t> out) {
+    std::ranges::transform(chars, out.begin(), [](const char32_t c) { return fold_case(c); });
+}
+
+std::u32string fold_case(const std::u32string_view chars) {
+    std::u32string folded(chars.size(), U'\0');
+    fold_case(chars, folded);
+    return folded;
+}
@@ -0,0 +1,71 @@
+#ifndef LEARNMON_CASE_FOLD_H
+#define LEARNMON_CASE_FOLD_H
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Simple (one-to-one) Unicode case folding for Latin (U+0000-U+017F) and
+// Cyrillic (U+0400-U+052F), e.g. 'Ө' -> 'ө' and 'Ү' -> 'ү'. Every codepoint
+// below U+0530 has an entry, so folding is one lookup; anything above is kept.
+inline constexpr size_t case_fold_table_size = 0x530;
+
+inline constexpr std::array<char32_t, case_fold_table_size> case_fold_table = [] {
+    std::array<char32_t, case_fold_table_size> table{};
+    for (size_t c = 0; c < table.size(); ++c) {
+        table[c] = static_cast<char32_t>(c);
+    }
+    // Ranges where upper- and lowercase letters alternate, starting with the
+    // uppercase one at `first`.
+    const auto alternating = [&](const char32_t first, const char32_t last) {
+        for (char32_t c = first; c < last; c += 2) {
+            table[c] = c + 1;
+        }
+    };
+
+    // Basic Latin and Latin-1 Supplement.
+    for (char32_t c = U'A'; c <= U'Z'; ++c) {
+        table[c] = c + 0x20;
+    }
+    for (char32_t c = 0xC0; c <= 0xDE; ++c) {
+        if (c != 0xD7) {
+            table[c] = c + 0x20;
+        }
+    }
+    table[0xB5] = 0x3BC; // MICRO SIGN folds to GREEK SMALL LETTER MU
+
+    // Latin Extended-A. U+0130 and U+0149 only have full foldings.
+    alternating(0x100, 0x130);
+    alternating(0x132, 0x138);
+    alternating(0x139, 0x149);
+    alternating(0x14A, 0x178);
+    table[0x178] = 0xFF;
+    alternating(0x179, 0x17F);
+    table[0x17F] = U's';
+
+    // Cyrillic and Cyrillic Supplement.
+    for (char32_t c = 0x400; c <= 0x40F; ++c) {
+        table[c] = c + 0x50;
+    }
+    for (char32_t c = 0x410; c <= 0x42F; ++c) {
+        table[c] = c + 0x20;
+    }
+    alternating(0x460, 0x482);
+    alternating(0x48A, 0x4C0);
+    table[0x4C0] = 0x4CF;
+    alternating(0x4C1, 0x4CF);
+    alternating(0x4D0, 0x530);
+    return table;
+}();
+
+constexpr char32_t fold_case(const char32_t c) {
+    return c < case_fold_table_size ? case_fold_table[c] : c;
+}
+
+// Folds `chars` into `out`, which must hold at least chars.size() codepoints.
+void fold_case(std::u32string_view chars, std::span<char32_t> out);
+std::u32string fold_case(std::u32string_view chars);
+
+#endif //LEARNMON_CASE_FOLD_H
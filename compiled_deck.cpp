@@ -0,0 +1,268 @@
+#include "compiled_deck.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <print>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "rng.h"
+#include "utf8.h"
+
+namespace {
+
+constexpr size_t lesson_count = 256;
+
+constexpr uint64_t align_to_8(const uint64_t value) {
+    return (value + 7) & ~uint64_t{7};
+}
+
+template<typename T>
+void write_value(std::ofstream &out, const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void write_padding(std::ofstream &out, const uint64_t written) {
+    constexpr std::array<char, 8> zeros{};
+    out.write(zeros.data(), static_cast<std::streamsize>(align_to_8(written) - written));
+}
+
+uint64_t row_pool_size(const LessonView &entry) {
+    return entry.word.size() + entry.description.size() + entry.origin_word.size();
+}
+
+template<typename T>
+const T *section(const std::string_view file, const uint64_t offset) {
+    return reinterpret_cast<const T *>(file.data() + offset);
+}
+
+// Checks that every section the header points at lies inside the file and is
+// aligned for its element type.
+bool sections_valid(const LmbHeader &header, const uint64_t file_size) {
+    const uint64_t n = header.entry_count;
+    if (n > file_size) {
+        return false;
+    }
+    const auto fits = [&](const uint64_t offset, const uint64_t size, const uint64_t alignment) {
+        return offset % alignment == 0 && offset <= file_size && size <= file_size - offset;
+    };
+    return fits(header.lesson_index_offset, lesson_count * sizeof(LmbLessonRange), alignof(LmbLessonRange)) &&
+           fits(header.lesson_numbers_offset, n, 1) &&
+           fits(header.offsets_offset, 3 * n * sizeof(uint64_t), alignof(uint64_t)) &&
+           fits(header.sizes_offset, 3 * n * sizeof(uint32_t), alignof(uint32_t)) &&
+           fits(header.word_char_offsets_offset, (n + 1) * sizeof(uint64_t), alignof(uint64_t)) &&
+           header.word_char_count <= file_size &&
+           fits(header.word_chars_offset, header.word_char_count * sizeof(char32_t), alignof(char32_t)) &&
+           fits(header.folded_word_chars_offset, header.word_char_count * sizeof(char32_t), alignof(char32_t)) &&
+           fits(header.pool_offset, header.pool_size, 1) &&
+           fits(header.distractor_offsets_offset, (n * distractor_pool_size + 1) * sizeof(uint64_t),
+                alignof(uint64_t)) &&
+           fits(header.distractor_text_offset, header.distractor_text_size, 1);
+}
+
+} // namespace
+
+bool write_compiled_deck(const Deck &deck, const std::filesystem::path &path) {
+    const LessonStore &lessons = deck.lessons;
+    const uint64_t n = lessons.size();
+
+    // Counting sort by lesson number; stable, so file order is kept within a lesson.
+    std::array<LmbLessonRange, lesson_count> index{};
+    for (const LessonView &entry : lessons.views()) {
+        ++index[entry.lesson_number].count;
+    }
+    uint64_t next = 0;
+    for (LmbLessonRange &range : index) {
+        range.first = next;
+        next += range.count;
+    }
+    std::vector<size_t> order(n);
+    std::array<uint64_t, lesson_count> fill{};
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t lesson = lessons.lesson_number(i);
+        order[index[lesson].first + fill[lesson]++] = i;
+    }
+
+    LmbHeader header;
+    header.magic = lmb_magic;
+    header.version = lmb_version;
+    header.byte_order = lmb_byte_order_mark;
+    header.entry_count = n;
+    header.lesson_index_offset = sizeof(LmbHeader);
+    header.lesson_numbers_offset = header.lesson_index_offset + lesson_count * sizeof(LmbLessonRange);
+    header.offsets_offset = align_to_8(header.lesson_numbers_offset + n);
+    header.sizes_offset = header.offsets_offset + 3 * n * sizeof(uint64_t);
+    header.word_char_offsets_offset = align_to_8(header.sizes_offset + 3 * n * sizeof(uint32_t));
+    header.word_chars_offset = header.word_char_offsets_offset + (n + 1) * sizeof(uint64_t);
+    for (const LessonView &entry : lessons.views()) {
+        header.pool_size += row_pool_size(entry);
+        header.word_char_count += entry.word_chars.size();
+    }
+    header.folded_word_chars_offset = align_to_8(header.word_chars_offset + header.word_char_count * sizeof(char32_t));
+    header.pool_offset =
+            align_to_8(header.folded_word_chars_offset + header.word_char_count * sizeof(char32_t));
+
+    // Distractor pools, in file order. The generator has a fixed seed, so
+    // compiling the same deck twice gives the same file.
+    Rng rng;
+    std::array<std::u32string, distractor_pool_size> distractors;
+    std::vector<uint64_t> distractor_offsets;
+    distractor_offsets.reserve(n * distractor_pool_size + 1);
+    distractor_offsets.push_back(0);
+    std::string distractor_text;
+    for (const size_t row : order) {
+        make_distractors(lessons.word_chars(row), distractors, rng);
+        for (const std::u32string &distractor : distractors) {
+            encode_utf8(distractor, distractor_text);
+            distractor_offsets.push_back(distractor_text.size());
+        }
+    }
+    header.distractors_per_row = distractor_pool_size;
+    header.distractor_offsets_offset = align_to_8(header.pool_offset + header.pool_size);
+    header.distractor_text_offset =
+            header.distractor_offsets_offset + distractor_offsets.size() * sizeof(uint64_t);
+    header.distractor_text_size = distractor_text.size();
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if (!out.is_open()) {
+        return false;
+    }
+
+    write_value(out, header);
+    for (const LmbLessonRange &range : index) {
+        write_value(out, range);
+    }
+    for (const size_t row : order) {
+        write_value(out, lessons.lesson_number(row));
+    }
+    write_padding(out, header.lesson_numbers_offset + n);
+
+    // The pool holds word, description and origin word of each row back to back.
+    const auto write_offsets = [&](auto field_start) {
+        uint64_t pool_offset = 0;
+        for (const size_t row : order) {
+            write_value(out, pool_offset + field_start(lessons[row]));
+            pool_offset += row_pool_size(lessons[row]);
+        }
+    };
+    write_offsets([](const LessonView &) { return uint64_t{0}; });
+    write_offsets([](const LessonView &e) { return uint64_t{e.word.size()}; });
+    write_offsets([](const LessonView &e) { return uint64_t{e.word.size() + e.description.size()}; });
+
+    const auto write_sizes = [&](auto field) {
+        for (const size_t row : order) {
+            write_value(out, static_cast<uint32_t>(field(lessons[row]).size()));
+        }
+    };
+    write_sizes([](const LessonView &e) { return e.word; });
+    write_sizes([](const LessonView &e) { return e.description; });
+    write_sizes([](const LessonView &e) { return e.origin_word; });
+    write_padding(out, header.sizes_offset + 3 * n * sizeof(uint32_t));
+
+    uint64_t word_char_offset = 0;
+    write_value(out, word_char_offset);
+    for (const size_t row : order) {
+        word_char_offset += lessons.word_chars(row).size();
+        write_value(out, word_char_offset);
+    }
+    const auto write_chars = [&](auto chars_of, const uint64_t section_offset) {
+        for (const size_t row : order) {
+            const std::u32string_view chars = chars_of(row);
+            out.write(reinterpret_cast<const char *>(chars.data()),
+                      static_cast<std::streamsize>(chars.size() * sizeof(char32_t)));
+        }
+        write_padding(out, section_offset + header.word_char_count * sizeof(char32_t));
+    };
+    write_chars([&](const size_t row) { return lessons.word_chars(row); }, header.word_chars_offset);
+    write_chars([&](const size_t row) { return lessons.folded_word_chars(row); }, header.folded_word_chars_offset);
+
+    for (const size_t row : order) {
+        const LessonView entry = lessons[row];
+        out.write(entry.word.data(), static_cast<std::streamsize>(entry.word.size()));
+        out.write(entry.description.data(), static_cast<std::streamsize>(entry.description.size()));
+        out.write(entry.origin_word.data(), static_cast<std::streamsize>(entry.origin_word.size()));
+    }
+    write_padding(out, header.pool_offset + header.pool_size);
+
+    out.write(reinterpret_cast<const char *>(distractor_offsets.data()),
+              static_cast<std::streamsize>(distractor_offsets.size() * sizeof(uint64_t)));
+    out.write(distractor_text.data(), static_cast<std::streamsize>(distractor_text.size()));
+
+    out.close();
+    return !out.fail();
+}
+
+bool is_compiled_deck(const std::filesystem::path &path) {
+    std::array<char, 4> magic{};
+    std::ifstream file{path, std::ios::binary};
+    return file.read(magic.data(), magic.size()) && magic == lmb_magic;
+}
+
+std::optional<Deck> load_compiled_deck(const std::filesystem::path &path, const std::optional<uint8_t> lesson_no) {
+    auto mapped = MappedFile::open(path);
+    if (!mapped.has_value()) {
+        std::println(std::cerr, "Error: Could not map file: {}", path.string());
+        return std::nullopt;
+    }
+    const std::string_view file = mapped->view();
+
+    LmbHeader header;
+    if (file.size() < sizeof(LmbHeader)) {
+        std::println(std::cerr, "Error: {} is not a compiled deck.", path.string());
+        return std::nullopt;
+    }
+    std::memcpy(&header, file.data(), sizeof(LmbHeader));
+    if (header.magic != lmb_magic || header.byte_order != lmb_byte_order_mark) {
+        std::println(std::cerr, "Error: {} is not a compiled deck for this platform.", path.string());
+        return std::nullopt;
+    }
+    if (header.version != lmb_version) {
+        std::println(std::cerr, "Error: {} has deck format version {}, expected {}. Recompile it.", path.string(),
+                     header.version, lmb_version);
+        return std::nullopt;
+    }
+    if (header.distractors_per_row != distractor_pool_size || !sections_valid(header, file.size())) {
+        std::println(std::cerr, "Error: {} is truncated or corrupt.", path.string());
+        return std::nullopt;
+    }
+
+    const auto *index = section<LmbLessonRange>(file, header.lesson_index_offset);
+    const auto *lesson_numbers = section<uint8_t>(file, header.lesson_numbers_offset);
+    const auto *offsets = section<uint64_t>(file, header.offsets_offset);
+    const auto *sizes = section<uint32_t>(file, header.sizes_offset);
+    const std::string_view pool = file.substr(header.pool_offset, header.pool_size);
+    const auto *word_char_offsets = section<uint64_t>(file, header.word_char_offsets_offset);
+    const std::u32string_view word_chars{section<char32_t>(file, header.word_chars_offset), header.word_char_count};
+    const std::u32string_view folded_word_chars{section<char32_t>(file, header.folded_word_chars_offset),
+                                                header.word_char_count};
+    const auto *distractor_offsets = section<uint64_t>(file, header.distractor_offsets_offset);
+    const std::string_view distractor_text = file.substr(header.distractor_text_offset, header.distractor_text_size);
+
+    const uint64_t n = header.entry_count;
+    const LmbLessonRange range = lesson_no.has_value() ? index[lesson_no.value()] : LmbLessonRange{0, n};
+    if (range.first > n || range.count > n - range.first) {
+        std::println(std::cerr, "Error: {} is truncated or corrupt.", path.string());
+        return std::nullopt;
+    }
+
+    // The columns are borrowed straight from the mapping, unread: LessonStore
+    // and DistractorPool cut each row's offsets to fit as the row is used.
+    const auto column = [&]<typename T>(const T *base, const size_t field) {
+        return std::span<const T>{base + field * n + range.first, range.count};
+    };
+    const std::array offset_columns = {column(offsets, 0), column(offsets, 1), column(offsets, 2)};
+    const std::array size_columns = {column(sizes, 0), column(sizes, 1), column(sizes, 2)};
+    const std::span<const uint64_t> char_offsets{word_char_offsets + range.first, range.count + 1};
+    const std::span<const uint64_t> pool_offsets{distractor_offsets + range.first * distractor_pool_size,
+                                                 range.count * distractor_pool_size + 1};
+
+    Deck deck;
+    deck.lessons = LessonStore::borrow(column(lesson_numbers, 0), offset_columns, size_columns, pool, char_offsets,
+                                       word_chars, folded_word_chars);
+    deck.distractors = DistractorPool{pool_offsets, distractor_text};
+    deck.source = std::make_shared<const MappedFile>(std::move(mapped.value()));
+    return deck;
+}
@@ -0,0 +1,81 @@
+#ifndef LEARNMON_COMPILED_DECK_H
+#define LEARNMON_COMPILED_DECK_H
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+#include "deck.h"
+
+// Binary deck (.lmb) layout, all integers in native byte order:
+//
+//   LmbHeader
+//   LmbLessonRange[256]              rows of each lesson number
+//   uint8_t  lesson_numbers[n]       padded to 8 bytes
+//   uint64_t word_offsets[n], description_offsets[n], origin_word_offsets[n]
+//   uint32_t word_sizes[n], description_sizes[n], origin_word_sizes[n]
+//                                    padded to 8 bytes
+//   uint64_t word_char_offsets[n + 1]
+//   char32_t word_chars[word_char_count]
+//                                    padded to 8 bytes
+//   char32_t folded_word_chars[word_char_count]
+//                                    padded to 8 bytes
+//   char     string_pool[pool_size]
+//                                    padded to 8 bytes
+//   uint64_t distractor_offsets[n * distractor_pool_size + 1]
+//   char     distractor_text[distractor_text_size]
+//
+// Rows are stored stably sorted by lesson number, so every lesson is one
+// contiguous range. String offsets are relative to the start of the pool and
+// word_chars holds each word already decoded into codepoints, and
+// folded_word_chars the same codepoints case-folded. The row sections
+// have the same shape as LessonStore's columns and are borrowed by it directly.
+// Each row's distractor pool is generated when the deck is compiled; row i's
+// k-th distractor spans distractor_offsets[i * distractor_pool_size + k] up to
+// the next offset in distractor_text.
+inline constexpr std::array<char, 4> lmb_magic = {'L', 'M', 'B', '\0'};
+inline constexpr uint32_t lmb_version = 4;
+inline constexpr uint32_t lmb_byte_order_mark = 0x01020304;
+
+struct LmbHeader {
+    std::array<char, 4> magic{};
+    uint32_t version{};
+    uint32_t byte_order{};
+    uint32_t reserved{};
+    uint64_t entry_count{};
+    uint64_t lesson_index_offset{};
+    uint64_t lesson_numbers_offset{};
+    uint64_t offsets_offset{};
+    uint64_t sizes_offset{};
+    uint64_t pool_offset{};
+    uint64_t pool_size{};
+    uint64_t word_char_offsets_offset{};
+    uint64_t word_chars_offset{};
+    uint64_t word_char_count{};
+    uint64_t folded_word_chars_offset{};
+    uint64_t distractors_per_row{};
+    uint64_t distractor_offsets_offset{};
+    uint64_t distractor_text_offset{};
+    uint64_t distractor_text_size{};
+};
+
+struct LmbLessonRange {
+    uint64_t first{};
+    uint64_t count{};
+};
+
+// Writes `deck` as a compiled .lmb file. Returns false if the file could not be written.
+bool write_compiled_deck(const Deck &deck, const std::filesystem::path &path);
+
+// True if the file starts with the .lmb magic.
+bool is_compiled_deck(const std::filesystem::path &path);
+
+// Maps a compiled deck. Nothing is parsed, decoded or scanned: only the header
+// and the section bounds are checked, in constant time, and the requested
+// lesson's rows are borrowed from the mapping. Row offsets are cut to fit
+// their sections as rows are read, so a corrupt file gives wrong text, never
+// a read outside the mapping, and opening a huge deck touches no row data.
+std::optional<Deck> load_compiled_deck(const std::filesystem::path &path, std::optional<uint8_t> lesson_no);
+
+#endif //LEARNMON_COMPILED_DECK_H
@@ -0,0 +1,116 @@
+#include "csv_scanner.h"
+
+#include <bit>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LEARNMON_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+size_t scan_scalar(const std::string_view block, const size_t from, uint32_t *out, size_t count) {
+    for (size_t i = from; i < block.size(); ++i) {
+        const char c = block[i];
+        // Branchless: always store, only advance when the byte is a delimiter.
+        out[count] = static_cast<uint32_t>(i);
+        count += static_cast<size_t>(c == ';' || c == '\n');
+    }
+    return count;
+}
+
+#ifdef LEARNMON_X86_SIMD
+
+template<typename Mask>
+size_t emit_mask(Mask mask, const size_t base, uint32_t *out, size_t count) {
+    while (mask != 0) {
+        out[count++] = static_cast<uint32_t>(base + static_cast<size_t>(std::countr_zero(mask)));
+        mask &= mask - 1;
+    }
+    return count;
+}
+
+size_t scan_sse2(const std::string_view block, uint32_t *out) {
+    const __m128i semicolon = _mm_set1_epi8(';');
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= block.size(); i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block.data() + i));
+        const __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, semicolon), _mm_cmpeq_epi8(bytes, newline));
+        count = emit_mask(static_cast<uint32_t>(_mm_movemask_epi8(hits)), i, out, count);
+    }
+    return scan_scalar(block, i, out, count);
+}
+
+__attribute__((target("avx2")))
+size_t scan_avx2(const std::string_view block, uint32_t *out) {
+    const __m256i semicolon = _mm256_set1_epi8(';');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 64 <= block.size(); i += 64) {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block.data() + i));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block.data() + i + 32));
+        const __m256i lo_hits = _mm256_or_si256(_mm256_cmpeq_epi8(lo, semicolon), _mm256_cmpeq_epi8(lo, newline));
+        const __m256i hi_hits = _mm256_or_si256(_mm256_cmpeq_epi8(hi, semicolon), _mm256_cmpeq_epi8(hi, newline));
+        const uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(lo_hits)) |
+                              static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi_hits))) << 32;
+        count = emit_mask(mask, i, out, count);
+    }
+    for (; i + 32 <= block.size(); i += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block.data() + i));
+        const __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, semicolon), _mm256_cmpeq_epi8(bytes, newline));
+        count = emit_mask(static_cast<uint32_t>(_mm256_movemask_epi8(hits)), i, out, count);
+    }
+    return scan_scalar(block, i, out, count);
+}
+
+#endif
+
+} // namespace
+
+ScanKernel detect_scan_kernel() {
+#ifdef LEARNMON_X86_SIMD
+    static const ScanKernel kernel = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return ScanKernel::Avx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return ScanKernel::Sse2;
+        }
+        return ScanKernel::Scalar;
+    }();
+    return kernel;
+#else
+    return ScanKernel::Scalar;
+#endif
+}
+
+std::string_view scan_kernel_name(const ScanKernel kernel) {
+    switch (kernel) {
+        case ScanKernel::Scalar: return "scalar";
+        case ScanKernel::Sse2: return "sse2";
+        case ScanKernel::Avx2: return "avx2";
+    }
+    return "unknown";
+}
+
+size_t scan_delimiters(const std::string_view block, const std::span<uint32_t> offsets) {
+    return scan_delimiters(block, offsets, detect_scan_kernel());
+}
+
+size_t scan_delimiters(const std::string_view block, const std::span<uint32_t> offsets, const ScanKernel kernel) {
+    switch (kernel) {
+#ifdef LEARNMON_X86_SIMD
+        case ScanKernel::Avx2: return scan_avx2(block, offsets.data());
+        case ScanKernel::Sse2: return scan_sse2(block, offsets.data());
+#else
+        case ScanKernel::Avx2:
+        case ScanKernel::Sse2:
+#endif
+        case ScanKernel::Scalar: break;
+    }
+    return scan_scalar(block, 0, offsets.data(), 0);
+}
@@ -0,0 +1,25 @@
+#ifndef LEARNMON_CSV_SCANNER_H
+#define LEARNMON_CSV_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+enum class ScanKernel {
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+// Best kernel supported by the running CPU. Detected once and cached.
+ScanKernel detect_scan_kernel();
+std::string_view scan_kernel_name(ScanKernel kernel);
+
+// Writes the offset of every ';' and '\n' in `block` to `offsets`, in order,
+// and returns how many were found. `offsets` must hold at least block.size()
+// elements and the block must be smaller than 4 GiB.
+size_t scan_delimiters(std::string_view block, std::span<uint32_t> offsets);
+size_t scan_delimiters(std::string_view block, std::span<uint32_t> offsets, ScanKernel kernel);
+
+#endif //LEARNMON_CSV_SCANNER_H
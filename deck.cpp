@@ -0,0 +1,607 @@
+#include "deck.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <print>
+#include <random>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include "compiled_deck.h"
+#include "csv_scanner.h"
+#include "lesson_index.h"
+#include "utf8.h"
+
+namespace {
+
+// Text is scanned in blocks of this size so the delimiter offsets stay in cache
+// and fit in 32 bits.
+constexpr size_t scan_block_size = size_t{1} << 20;
+
+// Below this many bytes per chunk, starting another thread costs more than it saves.
+constexpr size_t min_parallel_chunk_size = size_t{4} << 20;
+
+// Read size and kept issue details of sample_deck, which must stay bounded
+// however large the deck is.
+constexpr size_t stream_buffer_size = size_t{4} << 20;
+constexpr size_t max_streamed_issues = 1000;
+
+// Rows and skipped lines from one newline-aligned chunk. Issue line numbers
+// are 0-based within the chunk; `first_line` is the chunk's first line in the
+// file. If asked for, the chunk's lines are also collected into `index`, with
+// first lines 0-based within the chunk like the issues; `end` is the offset
+// just past the chunk.
+struct ChunkResult {
+    LessonColumns columns;
+    std::vector<ParseIssue> issues;
+    size_t line_count = 0;
+    size_t first_line = 1;
+    std::optional<LessonIndex> index;
+    uint64_t end = 0;
+};
+
+// `arena` is the start of the whole mapped text; field offsets are relative to
+// it. `invalid_utf8` is the offset of the line's first invalid UTF-8 sequence,
+// if it has one.
+void parse_line(const char *arena, const std::string_view line, const std::span<const size_t> separators,
+                const std::optional<size_t> invalid_utf8, const std::optional<uint8_t> lesson_no,
+                ChunkResult &result) {
+    const size_t line_no = result.line_count++;
+    const auto line_offset = static_cast<uint64_t>(line.data() - arena);
+    const LessonIndexRange line_range{line_offset, std::min(line_offset + line.size() + 1, result.end), line_no};
+    const auto skip = [&](const size_t column, const ParseError reason) {
+        result.issues.push_back({line_no, column, reason});
+        if (result.index.has_value()) {
+            add_index_range(result.index->skipped, line_range);
+        }
+    };
+    if (line.size() > std::numeric_limits<uint32_t>::max()) {
+        skip(1, ParseError::LineTooLong);
+        return;
+    }
+    if (separators.size() < 3) {
+        skip(line.size() + 1, ParseError::MissingFields);
+        return;
+    }
+    const size_t word_end = separators.size() > 3 ? separators[3] : line.size();
+
+    const auto current_lesson_no = parse_lesson_number(line.substr(0, separators[0]));
+    if (!current_lesson_no.has_value()) {
+        skip(current_lesson_no.error().column, current_lesson_no.error().reason);
+        return;
+    }
+    if (invalid_utf8.has_value()) {
+        skip(invalid_utf8.value() + 1, ParseError::InvalidUtf8);
+        return;
+    }
+    if (result.index.has_value()) {
+        add_index_range(result.index->lessons[current_lesson_no.value()], line_range);
+    }
+
+    if (lesson_no.has_value() && current_lesson_no.value() != lesson_no.value()) {
+        return;
+    }
+
+    result.columns.push_back(current_lesson_no.value(),
+                             {line_offset + separators[0] + 1, line_offset + separators[1] + 1,
+                              line_offset + separators[2] + 1},
+                             {static_cast<uint32_t>(separators[1] - separators[0] - 1),
+                              static_cast<uint32_t>(separators[2] - separators[1] - 1),
+                              static_cast<uint32_t>(word_end - separators[2] - 1)},
+                             line.substr(separators[0] + 1, separators[1] - separators[0] - 1));
+}
+
+// Offsets of the first invalid UTF-8 sequence of every line that has one, in
+// order. Valid text, the common case, is a single vectorised pass.
+std::vector<size_t> find_invalid_utf8(const std::string_view block) {
+    std::vector<size_t> invalid;
+    size_t from = 0;
+    while (from < block.size()) {
+        const auto checked = validate_utf8(block.substr(from));
+        if (checked.has_value()) {
+            break;
+        }
+        const size_t error = from + checked.error();
+        invalid.push_back(error);
+        // Carry on from the next line; the rest of this one is skipped anyway.
+        const size_t newline = block.find('\n', error);
+        from = newline == std::string_view::npos ? block.size() : newline + 1;
+    }
+    return invalid;
+}
+
+// Splits a block that ends on a line boundary using the delimiter offsets
+// produced by scan_delimiters and the UTF-8 errors found by find_invalid_utf8
+// for the whole block.
+void parse_block(const char *arena, const std::string_view block, const std::span<const uint32_t> delimiters,
+                 const std::span<const size_t> invalid_utf8, const std::optional<uint8_t> lesson_no,
+                 ChunkResult &result) {
+    std::array<size_t, 4> separators{};
+    size_t separator_count = 0;
+    size_t line_start = 0;
+    auto next_invalid = invalid_utf8.begin();
+    // The invalid offset inside the line ending at `line_end`, if there is one.
+    const auto invalid_before = [&](const size_t line_end) -> std::optional<size_t> {
+        if (next_invalid == invalid_utf8.end() || *next_invalid >= line_end) {
+            return std::nullopt;
+        }
+        return *next_invalid++ - line_start;
+    };
+    for (const uint32_t offset : delimiters) {
+        if (block[offset] == '\n') {
+            parse_line(arena, block.substr(line_start, offset - line_start),
+                       std::span{separators}.first(separator_count), invalid_before(offset), lesson_no, result);
+            line_start = offset + 1;
+            separator_count = 0;
+        } else if (separator_count < separators.size()) {
+            separators[separator_count++] = offset - line_start;
+        }
+    }
+    if (line_start < block.size()) {
+        parse_line(arena, block.substr(line_start), std::span{separators}.first(separator_count),
+                   invalid_before(block.size()), lesson_no, result);
+    }
+}
+
+// Returns the end of the line containing `pos`, including its newline.
+size_t line_boundary_after(const std::string_view text, const size_t pos) {
+    if (pos >= text.size()) {
+        return text.size();
+    }
+    const size_t newline = text.find('\n', pos);
+    return newline == std::string_view::npos ? text.size() : newline + 1;
+}
+
+// Parses the newline-aligned `text` into `result`, after the lines already
+// in it. `delimiters` is scratch space, grown as needed.
+void parse_lines(const char *arena, const std::string_view text, const std::optional<uint8_t> lesson_no,
+                 ChunkResult &result, std::vector<uint32_t> &delimiters) {
+    result.end = static_cast<uint64_t>(text.data() + text.size() - arena);
+    size_t block_start = 0;
+    while (block_start < text.size()) {
+        size_t block_end = std::min(text.size(), block_start + scan_block_size);
+        if (block_end < text.size()) {
+            // Cut at the last newline so that no line straddles two blocks.
+            const size_t last_newline = text.rfind('\n', block_end - 1);
+            block_end = last_newline != std::string_view::npos && last_newline >= block_start
+                            ? last_newline + 1
+                            : line_boundary_after(text, block_end);
+        }
+
+        const std::string_view block = text.substr(block_start, block_end - block_start);
+        if (delimiters.size() < block.size()) {
+            delimiters.resize(block.size());
+        }
+        const size_t count = scan_delimiters(block, delimiters);
+        parse_block(arena, block, std::span{delimiters}.first(count), find_invalid_utf8(block), lesson_no, result);
+        block_start = block_end;
+    }
+}
+
+ChunkResult parse_chunk(const char *arena, const std::string_view text, const std::optional<uint8_t> lesson_no,
+                        const bool collect_index = false) {
+    ChunkResult result;
+    if (collect_index) {
+        result.index.emplace();
+    }
+    if (!lesson_no.has_value()) {
+        // mong.csv-style rows average around 40 bytes, a quarter of which is
+        // the word.
+        result.columns.reserve(text.size() / 40, text.size() / 4);
+    }
+    std::vector<uint32_t> delimiters(std::min(text.size(), scan_block_size));
+    parse_lines(arena, text, lesson_no, result, delimiters);
+    return result;
+}
+
+// Splits `text` into at most `count` chunks that start and end on line boundaries.
+std::vector<std::string_view> split_into_chunks(const std::string_view text, const size_t count) {
+    std::vector<std::string_view> chunks;
+    chunks.reserve(count);
+    size_t chunk_start = 0;
+    for (size_t i = 1; i <= count && chunk_start < text.size(); ++i) {
+        const size_t chunk_end = i == count ? text.size() : line_boundary_after(text, text.size() / count * i);
+        if (chunk_end > chunk_start) {
+            chunks.push_back(text.substr(chunk_start, chunk_end - chunk_start));
+            chunk_start = chunk_end;
+        }
+    }
+    return chunks;
+}
+
+unsigned loader_thread_count(const size_t text_size, const unsigned requested) {
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    const size_t useful = std::max<size_t>(1, text_size / min_parallel_chunk_size);
+    return static_cast<unsigned>(std::min<size_t>(requested == 0 ? hardware : requested, useful));
+}
+
+// Concatenates the columns of every chunk in order, copying the chunks into
+// place in parallel on at most one thread per core.
+LessonColumns merge_chunks(std::vector<ChunkResult> &results) {
+    if (results.size() == 1) {
+        return std::move(results[0].columns);
+    }
+
+    std::vector<size_t> row_offsets(results.size());
+    std::vector<size_t> char_offsets(results.size());
+    size_t total_rows = 0;
+    size_t total_chars = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        row_offsets[i] = total_rows;
+        char_offsets[i] = total_chars;
+        total_rows += results[i].columns.size();
+        total_chars += results[i].columns.word_chars.size();
+    }
+
+    LessonColumns merged;
+    merged.lesson_numbers.resize(total_rows);
+    for (size_t column = 0; column < lesson_field_count; ++column) {
+        merged.offsets[column].resize(total_rows);
+        merged.sizes[column].resize(total_rows);
+    }
+    merged.word_chars.resize(total_chars);
+    merged.folded_word_chars.resize(total_chars);
+    merged.word_char_offsets.resize(total_rows + 1);
+    merged.word_char_offsets[total_rows] = total_chars;
+
+    const auto copy_chunk = [&](const size_t i) {
+        const auto at = static_cast<ptrdiff_t>(row_offsets[i]);
+        LessonColumns &chunk = results[i].columns;
+        std::ranges::copy(chunk.lesson_numbers, merged.lesson_numbers.begin() + at);
+        for (size_t column = 0; column < lesson_field_count; ++column) {
+            std::ranges::copy(chunk.offsets[column], merged.offsets[column].begin() + at);
+            std::ranges::copy(chunk.sizes[column], merged.sizes[column].begin() + at);
+        }
+        // Word offsets are relative to the chunk's codepoints; the
+        // closing offset of each chunk is the next chunk's first.
+        std::ranges::copy(chunk.word_chars,
+                          merged.word_chars.begin() + static_cast<ptrdiff_t>(char_offsets[i]));
+        std::ranges::copy(chunk.folded_word_chars,
+                          merged.folded_word_chars.begin() + static_cast<ptrdiff_t>(char_offsets[i]));
+        std::ranges::transform(std::span{chunk.word_char_offsets}.first(chunk.size()),
+                               merged.word_char_offsets.begin() + at,
+                               [base = char_offsets[i]](const uint64_t offset) { return base + offset; });
+        chunk = {};
+    };
+    {
+        const size_t worker_count =
+                std::min<size_t>(results.size(), std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<std::jthread> workers;
+        workers.reserve(worker_count);
+        for (size_t w = 0; w < worker_count; ++w) {
+            workers.emplace_back([&, w] {
+                for (size_t i = w; i < results.size(); i += worker_count) {
+                    copy_chunk(i);
+                }
+            });
+        }
+    }
+    return merged;
+}
+
+// Adds the lines and issues of `results` to `report`, in file order and with
+// absolute line numbers.
+void merge_reports(const std::span<const ChunkResult> results, LoadReport &report) {
+    for (const ChunkResult &result : results) {
+        report.lines += result.line_count;
+        for (const ParseIssue &issue : result.issues) {
+            report.add({result.first_line + issue.line, issue.column, issue.reason});
+        }
+    }
+}
+
+// Joins the indexes collected by the chunks, in order, into one for the whole
+// text, with absolute line numbers.
+LessonIndex merge_indexes(const std::span<const ChunkResult> results) {
+    LessonIndex merged;
+    const auto append = [](std::vector<LessonIndexRange> &into, const std::span<const LessonIndexRange> ranges,
+                           const size_t first_line) {
+        for (const LessonIndexRange &range : ranges) {
+            add_index_range(into, {range.begin, range.end, first_line + range.first_line});
+        }
+    };
+    for (const ChunkResult &result : results) {
+        for (size_t lesson = 0; lesson < merged.lessons.size(); ++lesson) {
+            append(merged.lessons[lesson], result.index->lessons[lesson], result.first_line);
+        }
+        append(merged.skipped, result.index->skipped, result.first_line);
+        merged.line_count += result.line_count;
+    }
+    return merged;
+}
+
+// Parses only the byte ranges `index` lists for `lesson_no`, and the skipped
+// lines so that their issues are reported too, into one result however many
+// ranges there are: a dirty deck has a range per skipped line. Its issues
+// carry absolute line numbers (first_line is 0). Returns nothing if a range
+// is outside `text`.
+std::optional<ChunkResult> parse_indexed_lesson(const LessonIndex &index, const std::string_view text,
+                                                const uint8_t lesson_no) {
+    std::vector<LessonIndexRange> ranges = index.lessons[lesson_no];
+    ranges.insert(ranges.end(), index.skipped.begin(), index.skipped.end());
+    std::ranges::sort(ranges, {}, &LessonIndexRange::begin);
+
+    ChunkResult result;
+    result.first_line = 0;
+    std::vector<uint32_t> delimiters;
+    for (const LessonIndexRange &range : ranges) {
+        if (range.end > text.size()) {
+            return std::nullopt;
+        }
+        const size_t issues_before = result.issues.size();
+        const size_t lines_before = result.line_count;
+        parse_lines(text.data(), text.substr(range.begin, range.end - range.begin), lesson_no, result, delimiters);
+        for (ParseIssue &issue : std::span{result.issues}.subspan(issues_before)) {
+            issue.line = range.first_line + (issue.line - lines_before);
+        }
+    }
+    return result;
+}
+
+// Parses the whole of `text` on up to `threads` threads (0 = one per core).
+// Results are in file order with their first line numbers set; with
+// `collect_index`, each also carries the index of its chunk.
+std::vector<ChunkResult> parse_text(const std::string_view text, const std::optional<uint8_t> lesson_no,
+                                    const unsigned threads, const bool collect_index = false) {
+    const std::vector<std::string_view> chunks = split_into_chunks(text, loader_thread_count(text.size(), threads));
+    std::vector<ChunkResult> results(chunks.size());
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(chunks.size());
+        for (size_t i = 1; i < chunks.size(); ++i) {
+            workers.emplace_back(
+                    [&, i] { results[i] = parse_chunk(text.data(), chunks[i], lesson_no, collect_index); });
+        }
+        if (!chunks.empty()) {
+            results[0] = parse_chunk(text.data(), chunks[0], lesson_no, collect_index);
+        }
+    }
+    for (size_t i = 1; i < results.size(); ++i) {
+        results[i].first_line = results[i - 1].first_line + results[i - 1].line_count;
+    }
+    return results;
+}
+
+// Reservoir sampling with Li's Algorithm L: after the reservoir is full, the
+// number of rows to skip before the next replacement is drawn directly, so
+// the random draws grow with log(n/k) rather than n.
+class ReservoirSampler {
+public:
+    ReservoirSampler(const size_t capacity, Rng &rng) : capacity_(capacity), rng_(rng) {}
+
+    // Slot the next row should be written to, or nothing if the row is skipped.
+    std::optional<size_t> offer() {
+        if (capacity_ == 0) {
+            return std::nullopt;
+        }
+        const uint64_t index = seen_++;
+        if (index < capacity_) {
+            if (index + 1 == capacity_) {
+                weight_ = std::exp(std::log(uniform()) / static_cast<double>(capacity_));
+                schedule_next(index);
+            }
+            return index;
+        }
+        if (index != next_) {
+            return std::nullopt;
+        }
+        weight_ *= std::exp(std::log(uniform()) / static_cast<double>(capacity_));
+        schedule_next(index);
+        return std::uniform_int_distribution<size_t>{0, capacity_ - 1}(rng_);
+    }
+
+private:
+    double uniform() {
+        return std::uniform_real_distribution<double>{std::nextafter(0.0, 1.0), 1.0}(rng_);
+    }
+
+    void schedule_next(const uint64_t index) {
+        const double skip = std::floor(std::log(uniform()) / std::log1p(-weight_));
+        next_ = skip < static_cast<double>(std::numeric_limits<uint64_t>::max() - index - 1)
+                    ? index + 1 + static_cast<uint64_t>(skip)
+                    : std::numeric_limits<uint64_t>::max();
+    }
+
+    size_t capacity_;
+    Rng &rng_;
+    uint64_t seen_ = 0;
+    uint64_t next_ = 0;
+    double weight_ = 0.0;
+};
+
+// A row kept by sample_deck. Only the text is kept: a row may be replaced
+// many times, so its word is decoded once, by pack_lessons.
+struct SampledRow {
+    uint8_t lesson_number{};
+    std::string word;
+    std::string description;
+    std::string origin_word;
+};
+
+// Packs sampled rows into a store that owns its text.
+LessonStore pack_lessons(const std::vector<SampledRow> &entries) {
+    size_t arena_size = 0;
+    for (const SampledRow &entry : entries) {
+        arena_size += entry.word.size() + entry.description.size() + entry.origin_word.size();
+    }
+
+    LessonColumns columns;
+    columns.reserve(entries.size());
+    std::vector<char> arena;
+    arena.reserve(arena_size);
+    for (const SampledRow &entry : entries) {
+        std::array<uint64_t, lesson_field_count> offsets{};
+        std::array<uint32_t, lesson_field_count> sizes{};
+        const std::array<std::string_view, lesson_field_count> fields = {entry.word, entry.description,
+                                                                         entry.origin_word};
+        for (size_t column = 0; column < lesson_field_count; ++column) {
+            offsets[column] = arena.size();
+            sizes[column] = static_cast<uint32_t>(fields[column].size());
+            arena.insert(arena.end(), fields[column].begin(), fields[column].end());
+        }
+        columns.push_back(entry.lesson_number, offsets, sizes, entry.word);
+    }
+    return LessonStore{std::move(columns), std::move(arena)};
+}
+
+} // namespace
+
+Deck load_deck(const std::filesystem::path &path, const std::optional<uint8_t> lesson_no, const unsigned threads) {
+    auto mapped = MappedFile::open(path);
+    if (!mapped.has_value()) {
+        std::println(std::cerr, "Error: Could not map file: {}", path.string());
+        return {};
+    }
+
+    Deck deck;
+    deck.source = std::make_shared<const MappedFile>(std::move(mapped.value()));
+    const std::string_view text = deck.source->view();
+
+    if (lesson_no.has_value()) {
+        if (const auto index = read_lesson_index(path, deck.source->stamp())) {
+            if (auto result = parse_indexed_lesson(index.value(), text, lesson_no.value())) {
+                deck.lessons = LessonStore{std::move(result->columns), text};
+                merge_reports(std::span{&result.value(), 1}, deck.report);
+                // The lines of other lessons were not read, but count all the same.
+                deck.report.lines = index->line_count;
+                return deck;
+            }
+        }
+    }
+
+    // Without an up-to-date index, a filtered load collects one while parsing,
+    // so the next single-lesson load only touches that lesson's bytes.
+    std::vector<ChunkResult> results = parse_text(text, lesson_no, threads, lesson_no.has_value());
+    if (lesson_no.has_value()) {
+        // Failing to write the index is harmless.
+        write_lesson_index(merge_indexes(results), path, deck.source->stamp());
+    }
+    deck.lessons = LessonStore{merge_chunks(results), text};
+    merge_reports(results, deck.report);
+    return deck;
+}
+
+Deck read_deck(const std::filesystem::path &path, const std::optional<uint8_t> lesson_no, const unsigned threads) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file.is_open()) {
+        std::println(std::cerr, "Error: Could not open file: {}", path.string());
+        return {};
+    }
+
+    // Read until the end rather than trusting the size up front: the file
+    // may still be growing while an editor writes it.
+    std::vector<char> arena;
+    std::error_code ec;
+    arena.resize(std::max<uintmax_t>(std::filesystem::file_size(path, ec) + 1, 4096));
+    size_t filled = 0;
+    while (file.read(arena.data() + filled, static_cast<std::streamsize>(arena.size() - filled)),
+           file.gcount() > 0) {
+        filled += static_cast<size_t>(file.gcount());
+        if (filled == arena.size()) {
+            arena.resize(arena.size() * 2);
+        }
+    }
+    arena.resize(filled);
+
+    Deck deck;
+    const std::string_view text{arena.data(), arena.size()};
+    std::vector<ChunkResult> results = parse_text(text, lesson_no, threads);
+    deck.lessons = LessonStore{merge_chunks(results), std::move(arena)};
+    merge_reports(results, deck.report);
+    return deck;
+}
+
+Deck open_deck(const std::filesystem::path &path, const std::optional<uint8_t> lesson_no) {
+    if (is_compiled_deck(path)) {
+        return load_compiled_deck(path, lesson_no).value_or(Deck{});
+    }
+    return load_deck(path, lesson_no);
+}
+
+Distractors deck_distractors(const Deck &deck, const size_t row, Rng &rng) {
+    if (deck.similar_words.empty()) {
+        return deck.distractors.row(row);
+    }
+    std::array<uint32_t, distractor_pool_size> rows{};
+    Distractors distractors;
+    distractors.count = deck.similar_words.find(deck.lessons, row, rows, rng);
+    for (size_t k = 0; k < distractors.count; ++k) {
+        distractors.words[k] = deck.lessons.field(rows[k], LessonField::Word);
+    }
+    return distractors;
+}
+
+Deck sample_deck(const std::filesystem::path &path, const std::optional<uint8_t> lesson_no, const size_t count,
+                 Rng &rng) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file.is_open()) {
+        std::println(std::cerr, "Error: Could not open file: {}", path.string());
+        return {};
+    }
+
+    Deck deck;
+    deck.report.max_issues = max_streamed_issues;
+    ReservoirSampler sampler{count, rng};
+    std::vector<SampledRow> reservoir;
+    reservoir.reserve(count);
+
+    // Rows are parsed a buffer at a time; a partial last line is carried over
+    // to the front of the buffer, which only grows for lines longer than it.
+    std::vector<char> buffer(stream_buffer_size);
+    size_t carried = 0;
+    size_t first_line = 1;
+    bool at_end = false;
+    while (!at_end) {
+        file.read(buffer.data() + carried, static_cast<std::streamsize>(buffer.size() - carried));
+        const size_t filled = carried + static_cast<size_t>(file.gcount());
+        at_end = filled < buffer.size();
+
+        const std::string_view text{buffer.data(), filled};
+        const size_t last_newline = text.rfind('\n');
+        size_t parse_end = at_end ? filled : last_newline + 1;
+        if (!at_end && last_newline == std::string_view::npos) {
+            buffer.resize(buffer.size() * 2);
+            carried = filled;
+            continue;
+        }
+
+        ChunkResult result = parse_chunk(buffer.data(), text.substr(0, parse_end), lesson_no);
+        result.first_line = first_line;
+        first_line += result.line_count;
+        merge_reports(std::span{&result, 1}, deck.report);
+
+        // Read the columns directly; most rows are never sampled.
+        const LessonColumns &rows = result.columns;
+        const auto field = [&](const size_t row, const LessonField field) {
+            const auto column = static_cast<size_t>(field);
+            return text.substr(rows.offsets[column][row], rows.sizes[column][row]);
+        };
+        for (size_t row = 0; row < rows.size(); ++row) {
+            const std::optional<size_t> slot = sampler.offer();
+            if (!slot.has_value()) {
+                continue;
+            }
+            if (slot.value() == reservoir.size()) {
+                reservoir.emplace_back();
+            }
+            SampledRow &entry = reservoir[slot.value()];
+            entry.lesson_number = rows.lesson_numbers[row];
+            entry.word.assign(field(row, LessonField::Word));
+            entry.description.assign(field(row, LessonField::Description));
+            entry.origin_word.assign(field(row, LessonField::OriginWord));
+        }
+
+        carried = filled - parse_end;
+        std::copy(buffer.begin() + static_cast<ptrdiff_t>(parse_end), buffer.begin() + static_cast<ptrdiff_t>(filled),
+                  buffer.begin());
+    }
+
+    deck.lessons = pack_lessons(reservoir);
+    return deck;
+}
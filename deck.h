@@ -0,0 +1,52 @@
+#ifndef LEARNMON_DECK_H
+#define LEARNMON_DECK_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+#include "distractors.h"
+#include "lesson_store.h"
+#include "mapped_file.h"
+#include "rng.h"
+#include "similar_words.h"
+
+// A loaded deck. The store's text lives in the mapped source file, which is
+// kept alive for as long as the deck exists. Compiled decks also carry each
+// row's precomputed distractors; for CSV decks the pool is empty. The
+// similar-word index is only built on request, after loading.
+struct Deck {
+    std::shared_ptr<const MappedFile> source;
+    LessonStore lessons;
+    DistractorPool distractors;
+    SimilarWords similar_words;
+    LoadReport report;
+};
+
+// Memory-maps a lesson CSV and splits it with the SIMD delimiter scanner,
+// without allocating per field. Large files are cut into newline-aligned chunks
+// parsed on `threads` threads (0 = one per core); rows keep file order.
+// Skipped lines are collected in the deck's report instead of being printed.
+// Accepts the same format as read_lesson_from_file.
+Deck load_deck(const std::filesystem::path &path, std::optional<uint8_t> lesson_no, unsigned threads = 0);
+
+// Same as load_deck, but reads the file into memory instead of mapping it, so
+// the deck stays intact if the file is edited in place or truncated later.
+Deck read_deck(const std::filesystem::path &path, std::optional<uint8_t> lesson_no, unsigned threads = 0);
+
+// Streams a lesson CSV once through a fixed-size buffer and keeps a uniform
+// random sample of at most `count` rows matching `lesson_no`. Memory is bounded
+// by the sample rather than the deck, so decks larger than RAM work. The
+// returned deck owns its text and has no source mapping.
+Deck sample_deck(const std::filesystem::path &path, std::optional<uint8_t> lesson_no, size_t count, Rng &rng);
+
+// Loads either a compiled .lmb deck or a lesson CSV, depending on the file contents.
+Deck open_deck(const std::filesystem::path &path, std::optional<uint8_t> lesson_no);
+
+// Ready-made distractors for a multiple-choice question on `row`: other deck
+// words a few edits away if the deck has a similar-word index, otherwise the
+// row's precomputed pool, which may be empty.
+Distractors deck_distractors(const Deck &deck, size_t row, Rng &rng);
+
+#endif //LEARNMON_DECK_H
@@ -0,0 +1,137 @@
+#include "deck_watcher.h"
+
+#include <iostream>
+#include <memory>
+#include <print>
+#include <utility>
+
+#if defined(__linux__)
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace {
+
+// A change is acted on once the file has been quiet this long, so an editor
+// writing in several steps causes one reload rather than one per write.
+constexpr int settle_ms = 100;
+
+} // namespace
+
+DeckWatcher::DeckWatcher(SharedDeck &decks, std::filesystem::path path, std::function<Deck()> load)
+    : decks_(decks), path_(std::move(path)), load_(std::move(load)) {
+    const std::filesystem::path directory = path_.parent_path().empty() ? "." : path_.parent_path();
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotify_fd_ < 0 || stop_fd_ < 0 ||
+        inotify_add_watch(inotify_fd_, directory.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        std::println(std::cerr, "Error: Cannot watch {}: {}", path_.string(), std::strerror(errno));
+        if (inotify_fd_ >= 0) {
+            close(inotify_fd_);
+            inotify_fd_ = -1;
+        }
+        return;
+    }
+    // The thread inherits a fully blocked signal mask, so signals meant for
+    // the server (e.g. through its signalfd) are never delivered to it.
+    sigset_t all;
+    sigset_t previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &previous);
+    thread_ = std::jthread{[this](const std::stop_token &stop) { run(stop); }};
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+}
+
+DeckWatcher::~DeckWatcher() {
+    if (thread_.joinable()) {
+        thread_.request_stop();
+        thread_.join();
+    }
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+    }
+    if (stop_fd_ >= 0) {
+        close(stop_fd_);
+    }
+}
+
+void DeckWatcher::run(const std::stop_token &stop) {
+    const std::stop_callback wake{stop, [this] {
+        constexpr uint64_t one = 1;
+        [[maybe_unused]] const auto written = write(stop_fd_, &one, sizeof(one));
+    }};
+
+    const std::string file_name = path_.filename().string();
+    alignas(inotify_event) std::array<char, 16 * 1024> buffer{};
+    std::array<pollfd, 2> fds = {pollfd{inotify_fd_, POLLIN, 0}, pollfd{stop_fd_, POLLIN, 0}};
+    std::optional<std::chrono::steady_clock::time_point> changed_at;
+
+    while (!stop.stop_requested()) {
+        // Block until something happens, or wait out the settle time once a
+        // change is pending.
+        const int ready = poll(fds.data(), fds.size(), changed_at.has_value() ? settle_ms : -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::println(std::cerr, "Error: Deck watcher stopped: {}", std::strerror(errno));
+            return;
+        }
+        if (ready == 0 && changed_at.has_value()) {
+            reload(changed_at.value());
+            changed_at.reset();
+            continue;
+        }
+        if ((fds[1].revents & POLLIN) != 0) {
+            return;
+        }
+
+        ssize_t n;
+        while ((n = read(inotify_fd_, buffer.data(), buffer.size())) > 0) {
+            for (ssize_t offset = 0; offset < n;) {
+                const auto *event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                if (event->len != 0 && file_name == event->name && !changed_at.has_value()) {
+                    changed_at = std::chrono::steady_clock::now();
+                }
+            }
+        }
+    }
+}
+
+#else
+
+DeckWatcher::DeckWatcher(SharedDeck &decks, std::filesystem::path path, std::function<Deck()> load)
+    : decks_(decks), path_(std::move(path)), load_(std::move(load)) {
+    std::println(std::cerr, "Error: Watching decks needs Linux (inotify).");
+}
+
+DeckWatcher::~DeckWatcher() = default;
+
+void DeckWatcher::run(const std::stop_token &) {}
+
+#endif
+
+void DeckWatcher::reload(const std::chrono::steady_clock::time_point changed_at) {
+    const auto parse_start = std::chrono::steady_clock::now();
+    auto deck = std::make_shared<Deck>(load_());
+    const auto parse_end = std::chrono::steady_clock::now();
+    print_load_report(deck->report, std::cerr);
+    if (deck->lessons.empty()) {
+        std::println(std::cerr, "Error: Reloaded {} has no lessons; keeping the current deck.", path_.string());
+        return;
+    }
+
+    const size_t rows = deck->lessons.size();
+    decks_.publish(std::move(deck));
+    const auto published = std::chrono::steady_clock::now();
+    std::println(std::cerr, "Reloaded {}: {} lessons, parsed in {:.1f} ms, live {:.1f} ms after the change.",
+                 path_.string(), rows, std::chrono::duration<double, std::milli>(parse_end - parse_start).count(),
+                 std::chrono::duration<double, std::milli>(published - changed_at).count());
+}
@@ -0,0 +1,42 @@
+#ifndef LEARNMON_DECK_WATCHER_H
+#define LEARNMON_DECK_WATCHER_H
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <stop_token>
+#include <thread>
+
+#include "shared_deck.h"
+
+// Hot reload for a served lesson CSV. The file's directory is watched with
+// inotify, so both in-place edits and editors that save by renaming a new file
+// over the old one are noticed. Once the changes settle, the whole file is
+// loaded again with `load` (e.g. read_deck) on the watcher's own thread and
+// the result is published to `decks`: lessons in flight are never paused, and
+// sessions that already started finish on the old snapshot. A file that fails to load or
+// has no lessons leaves the current deck in place. Every reload is logged to
+// std::cerr with its parse time and its latency from the first change.
+class DeckWatcher {
+public:
+    DeckWatcher(SharedDeck &decks, std::filesystem::path path, std::function<Deck()> load);
+    DeckWatcher(const DeckWatcher &) = delete;
+    DeckWatcher &operator=(const DeckWatcher &) = delete;
+    ~DeckWatcher();
+
+    // False if the watch could not be set up; the deck is then served as is.
+    [[nodiscard]] bool watching() const { return inotify_fd_ >= 0; }
+
+private:
+    void run(const std::stop_token &stop);
+    void reload(std::chrono::steady_clock::time_point changed_at);
+
+    SharedDeck &decks_;
+    std::filesystem::path path_;
+    std::function<Deck()> load_;
+    int inotify_fd_ = -1;
+    int stop_fd_ = -1;
+    std::jthread thread_; // last, so it starts after and stops before the rest
+};
+
+#endif //LEARNMON_DECK_WATCHER_H
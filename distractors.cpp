@@ -0,0 +1,77 @@
+#include "distractors.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "case_fold.h"
+
+namespace {
+
+constexpr std::u32string_view lower_letters = U"абвгдеёжзийклмноөпрстуүфхцчшщъыьэюя";
+constexpr std::u32string_view upper_letters = U"АБВГДЕЁЖЗИЙКЛМНОӨПРСТУҮФХЦЧШЩЪЫЬЭЮЯ";
+static_assert(lower_letters.size() == upper_letters.size());
+
+// Making a distractor differ from the ones before it gets this many tries.
+constexpr int max_attempts = 8;
+
+bool is_mongolian_letter(const char32_t c) {
+    return lower_letters.find(fold_case(c)) != std::u32string_view::npos;
+}
+
+// A letter other than `current`, uniformly from the alphabet of its case, in
+// one draw: the current letter's slot is skipped rather than retried.
+char32_t replacement_for(const char32_t current, Rng &rng) {
+    const std::u32string_view letters = fold_case(current) != current ? upper_letters : lower_letters;
+    const size_t skipped = letters.find(current);
+    const size_t candidates = letters.size() - (skipped == std::u32string_view::npos ? 0 : 1);
+    size_t pick = std::uniform_int_distribution<size_t>{0, candidates - 1}(rng);
+    if (pick >= skipped) {
+        ++pick;
+    }
+    return letters[pick];
+}
+
+} // namespace
+
+void make_distractors(const std::u32string_view word, const std::span<std::u32string> out,
+                      Rng &rng) {
+    // Positions worth changing: the Mongolian letters, or any non-space
+    // character if there are none.
+    std::vector<uint32_t> positions;
+    for (uint32_t i = 0; i < word.size(); ++i) {
+        if (is_mongolian_letter(word[i])) {
+            positions.push_back(i);
+        }
+    }
+    if (positions.empty()) {
+        for (uint32_t i = 0; i < word.size(); ++i) {
+            if (word[i] != U' ') {
+                positions.push_back(i);
+            }
+        }
+    }
+
+    for (size_t made = 0; made < out.size(); ++made) {
+        std::u32string &distractor = out[made];
+        for (int attempt = 0; attempt < max_attempts; ++attempt) {
+            distractor = word;
+            if (positions.empty()) {
+                distractor += lower_letters[std::uniform_int_distribution<size_t>{0, lower_letters.size() - 1}(rng)];
+            } else {
+                // Partial Fisher-Yates: the first `changes` positions become a
+                // uniform choice of distinct positions.
+                const size_t changes = std::min(positions.size(), std::uniform_int_distribution<size_t>{2, 4}(rng));
+                for (size_t i = 0; i < changes; ++i) {
+                    std::swap(positions[i],
+                              positions[std::uniform_int_distribution<size_t>{i, positions.size() - 1}(rng)]);
+                    distractor[positions[i]] = replacement_for(word[positions[i]], rng);
+                }
+            }
+            if (std::find(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(made), distractor) ==
+                out.begin() + static_cast<std::ptrdiff_t>(made)) {
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef LEARNMON_DISTRACTORS_H
+#define LEARNMON_DISTRACTORS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "rng.h"
+
+// Fake spellings shown next to the real word in multiple-choice lessons.
+
+// Distractors precomputed per row of a compiled deck. A question needs three,
+// so a lesson picks three of the row's pool and repeated questions vary.
+inline constexpr size_t distractor_pool_size = 4;
+
+// Ready-made distractors offered for one question: the first `count` of
+// `words`. A lesson generates whatever it needs beyond those.
+struct Distractors {
+    std::array<std::string_view, distractor_pool_size> words{};
+    size_t count = 0;
+};
+
+// Fills `out` with copies of `word` that have one to four letters replaced by
+// other Mongolian letters of the same case: two to four where the word has
+// enough letters. Each replacement is a single uniform draw and the number of
+// attempts at making the distractors differ from each other is bounded, so
+// this always terminates; words without letters get one appended instead.
+void make_distractors(std::u32string_view word, std::span<std::u32string> out, Rng &rng);
+
+// Borrowed view of the distractor sections of a compiled deck: row i's pool is
+// the texts between offsets[i * distractor_pool_size + k] and the next offset.
+class DistractorPool {
+public:
+    DistractorPool() = default;
+    // `offsets` has distractor_pool_size entries per row plus one.
+    DistractorPool(const std::span<const uint64_t> offsets, const std::string_view text)
+        : offsets_(offsets), text_(text) {}
+
+    [[nodiscard]] bool empty() const { return offsets_.size() <= 1; }
+
+    // The pool of `row`; empty if the deck has no precomputed pools.
+    [[nodiscard]] Distractors row(const size_t row) const {
+        Distractors distractors;
+        if (empty()) {
+            return distractors;
+        }
+        // The offsets come unchecked from a compiled deck; cut them to fit.
+        const size_t first = row * distractor_pool_size;
+        for (size_t k = 0; k < distractor_pool_size; ++k) {
+            const uint64_t begin = std::min<uint64_t>(offsets_[first + k], text_.size());
+            const uint64_t end = offsets_[first + k + 1];
+            distractors.words[k] = text_.substr(begin, end > begin ? end - begin : 0);
+        }
+        distractors.count = distractor_pool_size;
+        return distractors;
+    }
+
+private:
+    std::span<const uint64_t> offsets_;
+    std::string_view text_;
+};
+
+#endif //LEARNMON_DISTRACTORS_H
@@ -0,0 +1,169 @@
+#include "fuzzy_match.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+size_t difference(const size_t a, const size_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// Levenshtein distance over a band of 2 * limit + 1 diagonals, stopping once
+// a whole row exceeds the limit. Returns limit + 1 when the distance is larger.
+size_t banded_distance(const std::u32string_view a, const std::u32string_view b, const size_t limit) {
+    const size_t n = a.size();
+    const size_t m = b.size();
+    const size_t over = limit + 1;
+    if (difference(n, m) > limit) {
+        return over;
+    }
+    std::vector<size_t> previous(m + 1, over);
+    std::vector<size_t> current(m + 1, over);
+    for (size_t j = 0; j <= std::min(m, limit); ++j) {
+        previous[j] = j;
+    }
+    for (size_t i = 1; i <= n; ++i) {
+        std::ranges::fill(current, over);
+        current[0] = std::min(i, over);
+        size_t row_min = current[0];
+        for (size_t j = i > limit ? i - limit : 1; j <= std::min(m, i + limit); ++j) {
+            current[j] = std::min({previous[j - 1] + (a[i - 1] != b[j - 1] ? 1 : 0), previous[j] + 1,
+                                   current[j - 1] + 1, over});
+            row_min = std::min(row_min, current[j]);
+        }
+        if (row_min > limit) {
+            return over;
+        }
+        std::swap(previous, current);
+    }
+    return previous[m];
+}
+
+} // namespace
+
+FuzzyMatcher::FuzzyMatcher(const std::u32string_view expected) : expected_(expected) {
+    if (expected.size() > max_bit_parallel_length) {
+        return;
+    }
+    slots_.assign(slot_count, 0);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const uint64_t bit = uint64_t{1} << i;
+        uint64_t &slot = slots_[expected[i] % slot_count];
+        if (slot == 0 || expected[std::countr_zero(slot)] == expected[i]) {
+            slot |= bit;
+            continue;
+        }
+        const auto it = std::ranges::lower_bound(overflow_, expected[i], {}, &std::pair<char32_t, uint64_t>::first);
+        if (it != overflow_.end() && it->first == expected[i]) {
+            it->second |= bit;
+        } else {
+            overflow_.insert(it, {expected[i], bit});
+        }
+    }
+}
+
+uint64_t FuzzyMatcher::mask_of(const char32_t c) const {
+    if (const uint64_t slot = slots_[c % slot_count]; slot != 0 && expected_[std::countr_zero(slot)] == c) {
+        return slot;
+    }
+    if (overflow_.empty()) {
+        return 0;
+    }
+    const auto it = std::ranges::lower_bound(overflow_, c, {}, &std::pair<char32_t, uint64_t>::first);
+    return it != overflow_.end() && it->first == c ? it->second : 0;
+}
+
+size_t FuzzyMatcher::distance(const std::u32string_view answer, const size_t limit) const {
+    const size_t m = expected_.size();
+    const size_t n = answer.size();
+    const size_t over = limit + 1;
+    if (difference(m, n) > limit) {
+        return over;
+    }
+    if (m == 0 || n == 0) {
+        return m + n;
+    }
+    if (m > max_bit_parallel_length) {
+        return banded_distance(answer, expected_, limit);
+    }
+
+    // Column j of the table holds the distances from answer[0, j) to every
+    // prefix of the word, as vertical differences: bit i of `plus`/`minus`
+    // is set if row i + 1 is one more/less than row i. Row 0 is j.
+    const uint64_t last = uint64_t{1} << (m - 1);
+    uint64_t plus = m == 64 ? ~uint64_t{0} : (last << 1) - 1;
+    uint64_t minus = 0;
+    size_t score = m; // the bottom row: distance from answer[0, j) to the word
+    for (size_t j = 1; j <= n; ++j) {
+        const uint64_t equal = mask_of(answer[j - 1]);
+        const uint64_t vertical = equal | minus;
+        const uint64_t horizontal = (((equal & plus) + plus) ^ plus) | equal;
+        uint64_t horizontal_plus = minus | ~(horizontal | plus);
+        uint64_t horizontal_minus = plus & horizontal;
+        if ((horizontal_plus & last) != 0) {
+            ++score;
+        } else if ((horizontal_minus & last) != 0) {
+            --score;
+        }
+        horizontal_plus = (horizontal_plus << 1) | 1;
+        horizontal_minus <<= 1;
+        plus = horizontal_minus | ~(vertical | horizontal_plus);
+        minus = horizontal_plus & vertical;
+
+        // Distances never decrease along a diagonal, so the cell of this
+        // column on the diagonal that ends in the corner bounds the result
+        // from below. Its distance is a prefix sum of the differences.
+        if (j + m >= n) {
+            const size_t row = j + m - n;
+            const uint64_t above = row == 64 ? ~uint64_t{0} : (uint64_t{1} << row) - 1;
+            if (j + static_cast<size_t>(std::popcount(plus & above)) - static_cast<size_t>(std::popcount(minus & above)) >
+                limit) {
+                return over;
+            }
+        }
+    }
+    return std::min(score, over);
+}
+
+std::vector<AnswerMistake> FuzzyMatcher::mistakes(const std::u32string_view answer) const {
+    const size_t n = answer.size();
+    const size_t m = expected_.size();
+    const size_t width = m + 1;
+    std::vector<size_t> table((n + 1) * width);
+    const auto cell = [&](const size_t i, const size_t j) -> size_t & { return table[i * width + j]; };
+    for (size_t i = 0; i <= n; ++i) {
+        cell(i, 0) = i;
+    }
+    for (size_t j = 0; j <= m; ++j) {
+        cell(0, j) = j;
+    }
+    for (size_t i = 1; i <= n; ++i) {
+        for (size_t j = 1; j <= m; ++j) {
+            cell(i, j) = std::min({cell(i - 1, j - 1) + (answer[i - 1] != expected_[j - 1] ? 1 : 0),
+                                   cell(i - 1, j) + 1, cell(i, j - 1) + 1});
+        }
+    }
+
+    // Walk back from the corner, preferring a match or substitution.
+    std::vector<AnswerMistake> mistakes;
+    size_t i = n;
+    size_t j = m;
+    while (i > 0 || j > 0) {
+        if (i > 0 && j > 0 && cell(i, j) == cell(i - 1, j - 1) + (answer[i - 1] != expected_[j - 1] ? 1 : 0)) {
+            if (answer[i - 1] != expected_[j - 1]) {
+                mistakes.push_back({MistakeKind::Wrong, i - 1});
+            }
+            --i;
+            --j;
+        } else if (i > 0 && cell(i, j) == cell(i - 1, j) + 1) {
+            mistakes.push_back({MistakeKind::Extra, i - 1});
+            --i;
+        } else {
+            mistakes.push_back({MistakeKind::Missing, i});
+            --j;
+        }
+    }
+    std::ranges::reverse(mistakes);
+    return mistakes;
+}
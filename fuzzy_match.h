@@ -0,0 +1,62 @@
+#ifndef LEARNMON_FUZZY_MATCH_H
+#define LEARNMON_FUZZY_MATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// How a character of an answer differs from the expected word.
+enum class MistakeKind : uint8_t {
+    Wrong, // the answer has a different character here
+    Extra, // the answer has a character the word does not
+    Missing // the word has a character before this position that the answer lacks
+};
+
+// `position` indexes the answer's codepoints; a Missing character belongs
+// before it, or at the end if it equals the answer's length.
+struct AnswerMistake {
+    MistakeKind kind{};
+    size_t position{};
+};
+
+// Levenshtein distance from answers to one expected word, all case-folded
+// codepoints. The word is preprocessed once into one bit mask per distinct
+// character, so each answer (e.g. on every keystroke) costs a handful of word
+// operations per character with Myers' bit-parallel algorithm. Words longer
+// than 64 codepoints fall back to a dynamic-programming band of 2 * limit + 1
+// diagonals. The word must outlive the matcher.
+class FuzzyMatcher {
+public:
+    static constexpr size_t max_bit_parallel_length = 64;
+
+    FuzzyMatcher() = default;
+    explicit FuzzyMatcher(std::u32string_view expected);
+
+    // The distance from `answer` if it is at most `limit`, otherwise limit + 1.
+    // Gives up as soon as the answer characters read so far already cost more
+    // than the limit on the diagonal that leads to the result.
+    [[nodiscard]] size_t distance(std::u32string_view answer, size_t limit) const;
+
+    // The characters to change, drop or add to turn `answer` into the word,
+    // in answer order, along one cheapest alignment. Quadratic in the lengths:
+    // meant for answers already known to be near misses.
+    [[nodiscard]] std::vector<AnswerMistake> mistakes(std::u32string_view answer) const;
+
+private:
+    [[nodiscard]] uint64_t mask_of(char32_t c) const;
+
+    static constexpr size_t slot_count = 64;
+
+    std::u32string_view expected_;
+    // Bit i of a character's mask is set if expected_[i] is that character.
+    // A mask lives in the slot of its character's low bits, which tells apart
+    // all the Cyrillic letters of U+0430-U+046F, or in `overflow_` (sorted by
+    // character) if another character of the word took the slot first. Empty
+    // for words too long for one machine word.
+    std::vector<uint64_t> slots_;
+    std::vector<std::pair<char32_t, uint64_t>> overflow_;
+};
+
+#endif //LEARNMON_FUZZY_MATCH_H
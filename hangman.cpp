@@ -0,0 +1,62 @@
+#include "hangman.h"
+
+#include <algorithm>
+#include <numeric>
+
+HangmanGame::HangmanGame(const LessonView &lesson)
+    : word_chars_(lesson.word_chars), folded_word_chars_(lesson.folded_word_chars),
+      revealed_(lesson.word_chars.size(), U'_') {
+    // Group positions by folded letter with a stable sort, then record where
+    // each letter's run starts.
+    positions_.resize(folded_word_chars_.size());
+    std::iota(positions_.begin(), positions_.end(), uint32_t{0});
+    std::ranges::stable_sort(positions_, {}, [&](const uint32_t position) { return folded_word_chars_[position]; });
+
+    for (uint32_t i = 0; i < positions_.size();) {
+        const char32_t letter = folded_word_chars_[positions_[i]];
+        uint32_t end = i + 1;
+        while (end < positions_.size() && folded_word_chars_[positions_[end]] == letter) {
+            ++end;
+        }
+        letters_.push_back({letter, i, end - i, false});
+        i = end;
+    }
+
+    hidden_ = revealed_.size();
+    if (const auto space = std::ranges::lower_bound(letters_, U' ', {}, &Letter::letter);
+        space != letters_.end() && space->letter == U' ') {
+        reveal(*space);
+    }
+}
+
+HangmanGame::Guess HangmanGame::guess_letter(const char32_t letter) {
+    const auto found = std::ranges::lower_bound(letters_, letter, {}, &Letter::letter);
+    if (found == letters_.end() || found->letter != letter) {
+        return Guess::Miss;
+    }
+    if (found->revealed) {
+        return Guess::AlreadyRevealed;
+    }
+    reveal(*found);
+    return Guess::Hit;
+}
+
+bool HangmanGame::guess_word(const std::u32string_view word) {
+    if (word != folded_word_chars_) {
+        return false;
+    }
+    revealed_.assign(word_chars_);
+    hidden_ = 0;
+    for (Letter &letter : letters_) {
+        letter.revealed = true;
+    }
+    return true;
+}
+
+void HangmanGame::reveal(Letter &letter) {
+    for (uint32_t i = letter.first; i < letter.first + letter.count; ++i) {
+        revealed_[positions_[i]] = word_chars_[positions_[i]];
+    }
+    hidden_ -= letter.count;
+    letter.revealed = true;
+}
@@ -0,0 +1,55 @@
+#ifndef LEARNMON_HANGMAN_H
+#define LEARNMON_HANGMAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "lesson.h"
+
+// State of one hangman round. The revealed word is kept in place and only
+// the guessed letter's positions are written, so a letter guess costs
+// O(log distinct letters + occurrences) and the win check is O(1). Spaces are
+// shown from the start. The lesson's text must outlive the game.
+class HangmanGame {
+public:
+    enum class Guess {
+        Hit,
+        Miss,
+        AlreadyRevealed
+    };
+
+    explicit HangmanGame(const LessonView &lesson);
+
+    // `letter` must already be case-folded.
+    Guess guess_letter(char32_t letter);
+    // True if the folded `word` is the whole target; reveals it if so.
+    bool guess_word(std::u32string_view word);
+
+    [[nodiscard]] bool solved() const { return hidden_ == 0; }
+    [[nodiscard]] size_t hidden() const { return hidden_; }
+    // The word with unguessed letters shown as '_', in the word's own case.
+    [[nodiscard]] std::u32string_view revealed() const { return revealed_; }
+
+private:
+    // One distinct folded letter; its positions are positions_[first, first + count).
+    struct Letter {
+        char32_t letter;
+        uint32_t first;
+        uint32_t count;
+        bool revealed;
+    };
+
+    void reveal(Letter &letter);
+
+    std::u32string_view word_chars_;
+    std::u32string_view folded_word_chars_;
+    std::u32string revealed_;
+    size_t hidden_ = 0;
+    std::vector<Letter> letters_;       // sorted by letter
+    std::vector<uint32_t> positions_;   // grouped by letter
+};
+
+#endif //LEARNMON_HANGMAN_H
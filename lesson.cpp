@@ -0,0 +1,151 @@
+#include "lesson.h"
+
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <print>
+#include <ranges>
+
+std::vector<std::string> split(std::string_view s, const char delimiter) {
+    std::vector<std::string> tokens;
+    size_t start = 0, end = 0;
+    while ((end = s.find(delimiter, start)) != std::string_view::npos) {
+        tokens.emplace_back(s.substr(start, end - start));
+        start = end + 1;
+    }
+    tokens.emplace_back(s.substr(start));
+    return tokens;
+}
+
+std::vector<std::string> split_word_to_chars(std::string_view s) {
+    std::vector<std::string> chars;
+    for (size_t i = 0; i < s.length(); ) {
+        if ((s[i] & 0x80) == 0x00) {
+            chars.emplace_back(s.substr(i, 1));
+            i += 1;
+        } else if ((s[i] & 0xE0) == 0xC0) {
+            chars.emplace_back(s.substr(i, 2));
+            i += 2;
+        } else if ((s[i] & 0xF0) == 0xE0) {
+            chars.emplace_back(s.substr(i, 3));
+            i += 3;
+        } else if ((s[i] & 0xF8) == 0xF0) {
+            chars.emplace_back(s.substr(i, 4));
+            i += 4;
+        } else {
+            // Malformed UTF-8, fall back to single byte
+            chars.emplace_back(s.substr(i, 1));
+            i += 1;
+        }
+    }
+    return chars;
+}
+
+std::string_view parse_error_message(const ParseError error) {
+    switch (error) {
+        case ParseError::MissingFields: return "expected 4 fields separated by ';'";
+        case ParseError::LessonNumberNotANumber: return "lesson number is not a number";
+        case ParseError::LessonNumberOutOfRange: return "lesson number must be between 0 and 255";
+        case ParseError::LineTooLong: return "line is longer than 4 GiB";
+        case ParseError::InvalidUtf8: return "text is not valid UTF-8";
+    }
+    return "unknown error";
+}
+
+void LoadReport::add(const ParseIssue &issue) {
+    ++skipped[static_cast<size_t>(issue.reason)];
+    if (issues.size() < max_issues) {
+        issues.push_back(issue);
+    }
+}
+
+size_t LoadReport::skipped_lines() const {
+    return std::accumulate(skipped.begin(), skipped.end(), size_t{0});
+}
+
+void print_load_report(const LoadReport &report, std::ostream &out, const size_t max_listed) {
+    const size_t skipped_lines = report.skipped_lines();
+    if (skipped_lines == 0) {
+        return;
+    }
+
+    std::println(out, "Warning: Skipped {} of {} lines.", skipped_lines, report.lines);
+    for (size_t reason = 0; reason < report.skipped.size(); ++reason) {
+        if (report.skipped[reason] > 0) {
+            std::println(out, "  {:>10} x {}", report.skipped[reason],
+                         parse_error_message(static_cast<ParseError>(reason)));
+        }
+    }
+    for (const ParseIssue &issue : report.issues | std::views::take(max_listed)) {
+        std::println(out, "  line {}, column {}: {}", issue.line, issue.column, parse_error_message(issue.reason));
+    }
+    if (skipped_lines > max_listed) {
+        std::println(out, "  ... and {} more.", skipped_lines - max_listed);
+    }
+}
+
+std::expected<uint8_t, ParseIssue> parse_lesson_number(const std::string_view field) {
+    size_t start = field.find_first_not_of(" \t\n\v\f\r");
+    if (start == std::string_view::npos) {
+        return std::unexpected(ParseIssue{0, field.size() + 1, ParseError::LessonNumberNotANumber});
+    }
+    if (field[start] == '+') {
+        ++start;
+    }
+
+    int value = 0;
+    const auto [end, ec] = std::from_chars(field.data() + start, field.data() + field.size(), value);
+    if (ec == std::errc::invalid_argument) {
+        return std::unexpected(ParseIssue{0, start + 1, ParseError::LessonNumberNotANumber});
+    }
+    if (ec == std::errc::result_out_of_range || value < 0 || value > 255) {
+        return std::unexpected(ParseIssue{0, start + 1, ParseError::LessonNumberOutOfRange});
+    }
+    return static_cast<uint8_t>(value);
+}
+
+std::vector<LessonEntry> read_lesson_from_file(const std::filesystem::path &path,
+                                                const std::optional<uint8_t> lesson_no, LoadReport &report) {
+    std::vector<LessonEntry> result;
+    result.reserve(100);
+
+    if (std::ifstream file{path}; file.is_open()) {
+        std::string line;
+        while (std::getline(file, line)) {
+            const size_t line_no = ++report.lines;
+            const auto words = split(line, ';');
+
+            if (words.size() < 4) {
+                report.add({line_no, line.size() + 1, ParseError::MissingFields});
+                continue;
+            }
+
+            const auto current_lesson_no = parse_lesson_number(words[0]);
+            if (!current_lesson_no.has_value()) {
+                report.add({line_no, current_lesson_no.error().column, current_lesson_no.error().reason});
+                continue;
+            }
+
+            if (const auto checked = validate_utf8(line); !checked.has_value()) {
+                report.add({line_no, checked.error() + 1, ParseError::InvalidUtf8});
+                continue;
+            }
+
+            if (lesson_no.has_value() && current_lesson_no.value() != lesson_no.value()) {
+                continue;
+            }
+
+            result.emplace_back(current_lesson_no.value(), words[1], words[2], words[3]);
+        }
+    }
+    return result;
+}
+
+std::vector<LessonEntry> read_lesson_from_file(const std::filesystem::path &path,
+                                                const std::optional<uint8_t> lesson_no) {
+    LoadReport report;
+    auto result = read_lesson_from_file(path, lesson_no, report);
+    print_load_report(report, std::cerr);
+    return result;
+}
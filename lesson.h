@@ -0,0 +1,106 @@
+#ifndef LEARNMON_LESSON_H
+#define LEARNMON_LESSON_H
+
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "case_fold.h"
+#include "utf8.h"
+
+enum class LessonType {
+    Random = 0,
+    Spelling = 1,
+    MultipleChoice = 2,
+    Hangman = 3
+};
+
+// Non-owning view of one deck row. The strings point into whatever storage the
+// deck keeps alive (a mapped file, a string arena or an owning LessonEntry).
+// `word_chars` is `word` decoded into codepoints once, when the deck was loaded,
+// and `folded_word_chars` the same codepoints case-folded for comparing answers.
+struct LessonView {
+    uint8_t lesson_number{};
+    std::string_view word;
+    std::string_view description;
+    std::string_view origin_word;
+    std::u32string_view word_chars;
+    std::u32string_view folded_word_chars;
+};
+
+struct LessonEntry {
+    uint8_t lesson_number{};
+    std::string word;
+    std::string description;
+    std::string origin_word;
+    std::u32string word_chars;
+    std::u32string folded_word_chars;
+
+    LessonEntry(uint8_t num, std::string w, std::string d, std::string o)
+        : lesson_number(num), word(std::move(w)), description(std::move(d)), origin_word(std::move(o)),
+          word_chars(decode_utf8(word)), folded_word_chars(fold_case(word_chars)) {}
+
+    [[nodiscard]] LessonView view() const {
+        return {lesson_number, word, description, origin_word, word_chars, folded_word_chars};
+    }
+};
+
+enum class ParseError : uint8_t {
+    MissingFields,
+    LessonNumberNotANumber,
+    LessonNumberOutOfRange,
+    LineTooLong,
+    InvalidUtf8
+};
+
+inline constexpr size_t parse_error_count = 5;
+
+// Why a line was skipped. `line` and `column` are 1-based; the column points at
+// the byte where parsing failed.
+struct ParseIssue {
+    size_t line{};
+    size_t column{};
+    ParseError reason{};
+};
+
+// Outcome of loading a deck: how many lines were read, how many were skipped
+// for each reason, and the details of the first `max_issues` skipped lines.
+// Collected silently and printed once as a summary.
+struct LoadReport {
+    size_t lines = 0;
+    std::array<size_t, parse_error_count> skipped{};
+    std::vector<ParseIssue> issues;
+    size_t max_issues = std::numeric_limits<size_t>::max();
+
+    void add(const ParseIssue &issue);
+    [[nodiscard]] size_t skipped_lines() const;
+};
+
+std::string_view parse_error_message(ParseError error);
+
+// Prints how many lines were skipped per reason, followed by the first
+// `max_listed` issues. Prints nothing if there were no issues.
+void print_load_report(const LoadReport &report, std::ostream &out, size_t max_listed = 10);
+
+// Parses the lesson-number column like std::stoi does (leading whitespace and a
+// sign are accepted, trailing text is ignored) and checks it is 0-255, without
+// allocating or throwing. On failure the issue's column is relative to the
+// field and its line is left 0.
+std::expected<uint8_t, ParseIssue> parse_lesson_number(std::string_view field);
+
+std::vector<LessonEntry> read_lesson_from_file(const std::filesystem::path &path, std::optional<uint8_t> lesson_no,
+                                               LoadReport &report);
+// Same, printing the load report to std::cerr.
+std::vector<LessonEntry> read_lesson_from_file(const std::filesystem::path &path, std::optional<uint8_t> lesson_no);
+
+std::vector<std::string> split(std::string_view s, char delimiter);
+std::vector<std::string> split_word_to_chars(std::string_view s);
+
+#endif //LEARNMON_LESSON_H
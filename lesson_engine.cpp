@@ -0,0 +1,232 @@
+#include "lesson_engine.h"
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <random>
+#include <utility>
+
+#include "case_fold.h"
+#include "distractors.h"
+#include "utf8.h"
+
+namespace {
+
+using Choices = std::array<std::string, MultipleChoiceLesson::choice_count>;
+
+// The correct word plus three distractors, shuffled: as many as possible
+// picked at random from the ready-made ones and the rest generated. Returns
+// the choices and the index of the correct one.
+std::pair<Choices, size_t> make_choices(const LessonView &lesson, const Distractors &given, Rng &rng) {
+    std::pair<Choices, size_t> result;
+    Choices &choices = result.first;
+    choices[0] = lesson.word;
+
+    std::array<std::string_view, distractor_pool_size> words = given.words;
+    const size_t taken = std::min(given.count, choices.size() - 1);
+    for (size_t k = 0; k < taken; ++k) {
+        std::swap(words[k], words[std::uniform_int_distribution<size_t>{k, given.count - 1}(rng)]);
+        choices[k + 1] = words[k];
+    }
+    if (taken + 1 < choices.size()) {
+        std::array<std::u32string, MultipleChoiceLesson::choice_count - 1> generated;
+        const std::span missing = std::span{generated}.first(choices.size() - 1 - taken);
+        make_distractors(lesson.word_chars, missing, rng);
+        for (size_t k = 0; k < missing.size(); ++k) {
+            choices[taken + 1 + k] = encode_utf8(missing[k]);
+        }
+    }
+
+    std::ranges::shuffle(choices, rng);
+    result.second = static_cast<size_t>(std::ranges::find(choices, lesson.word) - choices.begin());
+    return result;
+}
+
+// Parses a choice number like std::stoi would: leading whitespace and a '+'
+// are skipped and trailing text is ignored.
+std::optional<int> parse_choice(std::string_view input) {
+    while (!input.empty() && (input.front() == ' ' || input.front() == '\t')) {
+        input.remove_prefix(1);
+    }
+    if (input.starts_with('+')) {
+        input.remove_prefix(1);
+    }
+    int choice = 0;
+    if (const auto [end, ec] = std::from_chars(input.data(), input.data() + input.size(), choice);
+        ec != std::errc{}) {
+        return std::nullopt;
+    }
+    return choice;
+}
+
+// The answer with every wrong or extra character in brackets and a "[_]"
+// where one is missing.
+std::string mark_mistakes(const std::u32string_view answer, const std::span<const AnswerMistake> mistakes) {
+    std::u32string marked;
+    auto mistake = mistakes.begin();
+    for (size_t i = 0; i <= answer.size(); ++i) {
+        bool wrong = false;
+        for (; mistake != mistakes.end() && mistake->position == i; ++mistake) {
+            if (mistake->kind == MistakeKind::Missing) {
+                marked += U"[_]";
+            } else {
+                wrong = true;
+            }
+        }
+        if (i == answer.size()) {
+            break;
+        }
+        if (wrong) {
+            marked += U'[';
+            marked += answer[i];
+            marked += U']';
+        } else {
+            marked += answer[i];
+        }
+    }
+    return encode_utf8(marked);
+}
+
+std::string found_message(const LessonView &lesson) {
+    return std::format("\nYou found the word! \n{}\n{}\n{}", lesson.word, lesson.description, lesson.origin_word);
+}
+
+} // namespace
+
+LessonResult SpellingLesson::submit(const std::string_view input) {
+    if (input.empty()) {
+        return {};
+    }
+
+    const std::u32string answer = fold_case(decode_utf8(input));
+    if (answer == U"hint") {
+        return {LessonStatus::InProgress, std::string{lesson_.description}};
+    }
+    if (answer == U"quit") {
+        return {LessonStatus::Failed, std::format("The correct spelling is: {} ", lesson_.word)};
+    }
+    if (answer == lesson_.folded_word_chars) {
+        return {LessonStatus::Solved, std::format("Correct! The word is: {}", lesson_.word)};
+    }
+    if (const size_t distance = matcher_ ? matcher_->distance(answer, near_miss_) : 1;
+        distance <= near_miss_) {
+        return {LessonStatus::Solved,
+                std::format("Almost! {} {} off: {}\nThe word is: {}", distance,
+                            distance == 1 ? "character" : "characters",
+                            mark_mistakes(decode_utf8(input), matcher_->mistakes(answer)), lesson_.word)};
+    }
+    return {LessonStatus::InProgress, "Incorrect. Try again."};
+}
+
+LessonScreen SpellingLesson::render() const {
+    return {std::format("How do you spell {}?", lesson_.origin_word), "Your answer:"};
+}
+
+MultipleChoiceLesson::MultipleChoiceLesson(const LessonView &lesson, Rng &rng, const Distractors &distractors)
+    : lesson_(lesson) {
+    std::tie(choices_, correct_choice_) = make_choices(lesson, distractors, rng);
+}
+
+LessonResult MultipleChoiceLesson::submit(const std::string_view input) {
+    if (input.empty()) {
+        return {};
+    }
+    if (input == "quit") {
+        return {LessonStatus::Failed, std::format("The word was: {} ", lesson_.word)};
+    }
+
+    const std::optional<int> choice = parse_choice(input);
+    if (!choice.has_value()) {
+        return {LessonStatus::InProgress, "Invalid input! Please enter a number."};
+    }
+    if (choice.value() < 1 || choice.value() > static_cast<int>(choice_count)) {
+        return {LessonStatus::InProgress, "Invalid input! Please enter a number between 1 and 4."};
+    }
+    if (static_cast<size_t>(choice.value()) == correct_choice_ + 1) {
+        return {LessonStatus::Solved, std::format("Correct! You found the word! \n{}\n{}\n{}", lesson_.word,
+                                                  lesson_.description, lesson_.origin_word)};
+    }
+    return {LessonStatus::Failed, std::format("Wrong! The correct choice was {}!\nThe word was: {}\n{}\n{}",
+                                              correct_choice_ + 1, lesson_.word, lesson_.description,
+                                              lesson_.origin_word)};
+}
+
+LessonScreen MultipleChoiceLesson::render() const {
+    LessonScreen screen;
+    for (size_t i = 0; i < choices_.size(); ++i) {
+        std::format_to(std::back_inserter(screen.header), "{}{}. {}", i == 0 ? "" : "\n", i + 1, choices_[i]);
+    }
+    screen.prompt = std::format("\nHow do you spell {}?\nEnter your choice (1-4):", lesson_.origin_word);
+    return screen;
+}
+
+LessonResult HangmanLesson::submit(const std::string_view input) {
+    if (input.empty()) {
+        return {};
+    }
+
+    const std::u32string guess = fold_case(decode_utf8(input));
+    if (guess == U"quit") {
+        return {LessonStatus::Failed, std::format("The word was: {} ", lesson_.word)};
+    }
+    if (game_.guess_word(guess)) {
+        return {LessonStatus::Solved, found_message(lesson_)};
+    }
+
+    LessonResult result;
+    if (guess.size() != 1 || game_.guess_letter(guess.front()) == HangmanGame::Guess::Miss) {
+        result.message = "Wrong!";
+    }
+    if (game_.solved()) {
+        result.status = LessonStatus::Solved;
+        result.message += found_message(lesson_);
+    }
+    return result;
+}
+
+LessonScreen HangmanLesson::render() const {
+    return {std::format("\nGuess the word!\n Current: {}", encode_utf8(game_.revealed())),
+            "Enter a letter or a full word:", true};
+}
+
+LessonType resolve_lesson_type(const LessonType type, Rng &rng) {
+    if (type != LessonType::Random) {
+        return type;
+    }
+    switch (std::uniform_int_distribution<>(1, 3)(rng)) {
+        case 1: return LessonType::Spelling;
+        case 2: return LessonType::MultipleChoice;
+        case 3: return LessonType::Hangman;
+        default: std::unreachable();
+    }
+}
+
+void LessonEngine::start(const LessonType type, const LessonView &lesson, Rng &rng, const Distractors &distractors) {
+    switch (type) {
+        case LessonType::Spelling: lesson_.emplace<SpellingLesson>(lesson, near_miss_); return;
+        case LessonType::MultipleChoice: lesson_.emplace<MultipleChoiceLesson>(lesson, rng, distractors); return;
+        case LessonType::Hangman: lesson_.emplace<HangmanLesson>(lesson); return;
+        case LessonType::Random: break;
+    }
+    std::unreachable();
+}
+
+LessonResult LessonEngine::submit(const std::string_view input) {
+    return std::visit([&]<typename Lesson>(Lesson &lesson) -> LessonResult {
+        if constexpr (std::is_same_v<Lesson, std::monostate>) {
+            return {LessonStatus::Failed, {}};
+        } else {
+            return lesson.submit(input);
+        }
+    }, lesson_);
+}
+
+LessonScreen LessonEngine::render() const {
+    return std::visit([]<typename Lesson>(const Lesson &lesson) -> LessonScreen {
+        if constexpr (std::is_same_v<Lesson, std::monostate>) {
+            return {};
+        } else {
+            return lesson.render();
+        }
+    }, lesson_);
+}
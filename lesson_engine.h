@@ -0,0 +1,120 @@
+#ifndef LEARNMON_LESSON_ENGINE_H
+#define LEARNMON_LESSON_ENGINE_H
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "distractors.h"
+#include "fuzzy_match.h"
+#include "hangman.h"
+#include "lesson.h"
+#include "rng.h"
+
+// Headless lesson state machines. Nothing here reads input or prints: a
+// frontend calls start() with a deck row, shows render(), and passes every
+// line the learner types to submit() until the lesson is no longer in
+// progress. Engines keep views into the deck, which must outlive them.
+
+enum class LessonStatus {
+    InProgress,
+    Solved,
+    Failed
+};
+
+// Outcome of one submitted line: where the lesson stands and the feedback to
+// show, which may be empty (e.g. for a blank line).
+struct LessonResult {
+    LessonStatus status = LessonStatus::InProgress;
+    std::string message;
+};
+
+// What to show before reading the next line. `header` is shown when the
+// lesson starts and, if `redraw` is set, on a cleared screen before every
+// line; `prompt` is shown before every line.
+struct LessonScreen {
+    std::string header;
+    std::string prompt;
+    bool redraw = false;
+};
+
+class SpellingLesson {
+public:
+    // Characters of the word per edit a near miss may have.
+    static constexpr size_t letters_per_near_miss = 4;
+
+    // Answers within `near_miss` edits of the word also count as solved, with
+    // the wrong characters marked; 0 accepts exact answers only. The allowance
+    // shrinks to one edit per letters_per_near_miss characters of the word, so
+    // words under four characters need the exact answer and a wrong or empty
+    // answer to a short word is never within reach.
+    explicit SpellingLesson(const LessonView &lesson, const size_t near_miss = 0)
+        : lesson_(lesson),
+          near_miss_(std::min(near_miss, lesson.folded_word_chars.size() / letters_per_near_miss)),
+          matcher_(near_miss_ > 0 ? std::optional<FuzzyMatcher>{lesson.folded_word_chars} : std::nullopt) {}
+
+    LessonResult submit(std::string_view input);
+    [[nodiscard]] LessonScreen render() const;
+
+private:
+    LessonView lesson_;
+    size_t near_miss_;
+    std::optional<FuzzyMatcher> matcher_; // only built when near misses are accepted
+};
+
+class MultipleChoiceLesson {
+public:
+    static constexpr size_t choice_count = 4;
+
+    // Up to three of `distractors` are shown, picked at random; the rest are generated.
+    MultipleChoiceLesson(const LessonView &lesson, Rng &rng, const Distractors &distractors = {});
+
+    LessonResult submit(std::string_view input);
+    [[nodiscard]] LessonScreen render() const;
+
+private:
+    LessonView lesson_;
+    std::array<std::string, choice_count> choices_;
+    size_t correct_choice_ = 0;
+};
+
+class HangmanLesson {
+public:
+    explicit HangmanLesson(const LessonView &lesson) : lesson_(lesson), game_(lesson) {}
+
+    LessonResult submit(std::string_view input);
+    [[nodiscard]] LessonScreen render() const;
+
+private:
+    LessonView lesson_;
+    HangmanGame game_;
+};
+
+// `type` itself, or one of the three lessons at random for LessonType::Random.
+LessonType resolve_lesson_type(LessonType type, Rng &rng);
+
+// Any of the three lessons behind one interface, stored inline so that a
+// session costs no allocation beyond the lesson's own state.
+class LessonEngine {
+public:
+    // `near_miss` is passed on to every spelling lesson.
+    explicit LessonEngine(const size_t near_miss = 0) : near_miss_(near_miss) {}
+
+    // `type` must not be LessonType::Random; pick one first. `distractors`
+    // are ready-made ones for a multiple-choice lesson, e.g. deck_distractors();
+    // the other lessons ignore them, so callers look them up only for that one.
+    void start(LessonType type, const LessonView &lesson, Rng &rng, const Distractors &distractors = {});
+    LessonResult submit(std::string_view input);
+    [[nodiscard]] LessonScreen render() const;
+
+    [[nodiscard]] bool started() const { return !std::holds_alternative<std::monostate>(lesson_); }
+
+private:
+    std::variant<std::monostate, SpellingLesson, MultipleChoiceLesson, HangmanLesson> lesson_;
+    size_t near_miss_;
+};
+
+#endif //LEARNMON_LESSON_ENGINE_H
@@ -0,0 +1,152 @@
+#include "lesson_index.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <random>
+#include <span>
+
+#include <unistd.h>
+
+namespace {
+
+constexpr std::array<char, 4> lmi_magic = {'L', 'M', 'I', '\0'};
+constexpr uint32_t lmi_version = 3;
+
+struct LmiHeader {
+    std::array<char, 4> magic{};
+    uint32_t version{};
+    uint64_t source_size{};
+    int64_t source_mtime{};
+    uint64_t range_count{};
+    uint64_t skipped_count{};
+    uint64_t line_count{};
+};
+
+bool ranges_fit(const std::span<const LessonIndexRange> ranges, const uint64_t source_size) {
+    return std::ranges::all_of(ranges, [&](const LessonIndexRange &range) {
+        return range.begin <= range.end && range.end <= source_size;
+    });
+}
+
+template<typename T>
+void write_value(std::ofstream &out, const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read_value(std::ifstream &in, T &value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+} // namespace
+
+void add_index_range(std::vector<LessonIndexRange> &ranges, const LessonIndexRange &range) {
+    if (!ranges.empty() && ranges.back().end == range.begin) {
+        ranges.back().end = range.end;
+    } else {
+        ranges.push_back(range);
+    }
+}
+
+std::filesystem::path lesson_index_path(const std::filesystem::path &deck_path) {
+    std::filesystem::path path = deck_path;
+    path += ".lmi";
+    return path;
+}
+
+bool write_lesson_index(const LessonIndex &index, const std::filesystem::path &deck_path, const FileStamp &stamp) {
+    LmiHeader header;
+    header.magic = lmi_magic;
+    header.version = lmi_version;
+    header.source_size = stamp.size;
+    header.source_mtime = stamp.mtime;
+    for (const auto &ranges : index.lessons) {
+        header.range_count += ranges.size();
+    }
+    header.skipped_count = index.skipped.size();
+    header.line_count = index.line_count;
+
+    // Write to a temporary name and rename, so a concurrent reader never sees
+    // a half-written index. The name is unique to this writer, as two cold
+    // loads of the same deck may write their indexes at once.
+    std::filesystem::path temp_path = lesson_index_path(deck_path);
+    temp_path += std::format(".{}.{:08x}.tmp", getpid(), std::random_device{}());
+    std::error_code ec;
+    {
+        std::ofstream out{temp_path, std::ios::binary | std::ios::trunc};
+        if (!out.is_open()) {
+            return false;
+        }
+        write_value(out, header);
+        for (const auto &ranges : index.lessons) {
+            write_value(out, static_cast<uint64_t>(ranges.size()));
+        }
+        for (const auto &ranges : index.lessons) {
+            out.write(reinterpret_cast<const char *>(ranges.data()),
+                      static_cast<std::streamsize>(ranges.size() * sizeof(LessonIndexRange)));
+        }
+        out.write(reinterpret_cast<const char *>(index.skipped.data()),
+                  static_cast<std::streamsize>(index.skipped.size() * sizeof(LessonIndexRange)));
+        if (!out.flush()) {
+            out.close();
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp_path, lesson_index_path(deck_path), ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<LessonIndex> read_lesson_index(const std::filesystem::path &deck_path, const FileStamp &stamp) {
+    std::ifstream in{lesson_index_path(deck_path), std::ios::binary};
+    if (!in.is_open()) {
+        return std::nullopt;
+    }
+
+    LmiHeader header;
+    if (!read_value(in, header) || header.magic != lmi_magic || header.version != lmi_version ||
+        header.source_size != stamp.size || header.source_mtime != stamp.mtime ||
+        header.range_count > header.source_size || header.skipped_count > header.source_size) {
+        return std::nullopt;
+    }
+
+    std::array<uint64_t, 256> counts{};
+    uint64_t total = 0;
+    for (uint64_t &count : counts) {
+        if (!read_value(in, count) || count > header.range_count - total) {
+            return std::nullopt;
+        }
+        total += count;
+    }
+    if (total != header.range_count) {
+        return std::nullopt;
+    }
+
+    LessonIndex index;
+    for (size_t lesson = 0; lesson < counts.size(); ++lesson) {
+        auto &ranges = index.lessons[lesson];
+        ranges.resize(counts[lesson]);
+        if (!in.read(reinterpret_cast<char *>(ranges.data()),
+                     static_cast<std::streamsize>(ranges.size() * sizeof(LessonIndexRange)))) {
+            return std::nullopt;
+        }
+        if (!ranges_fit(ranges, header.source_size)) {
+            return std::nullopt;
+        }
+    }
+
+    index.skipped.resize(header.skipped_count);
+    if (!in.read(reinterpret_cast<char *>(index.skipped.data()),
+                 static_cast<std::streamsize>(index.skipped.size() * sizeof(LessonIndexRange))) ||
+        !ranges_fit(index.skipped, header.source_size)) {
+        return std::nullopt;
+    }
+    index.line_count = header.line_count;
+    return index;
+}
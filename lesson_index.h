@@ -0,0 +1,50 @@
+#ifndef LEARNMON_LESSON_INDEX_H
+#define LEARNMON_LESSON_INDEX_H
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "mapped_file.h"
+
+// A run of consecutive CSV lines that all belong to the same lesson.
+// `begin` and `end` are byte offsets into the deck; `end` is just past the
+// run's last newline. `first_line` is the 1-based line number of `begin`.
+struct LessonIndexRange {
+    uint64_t begin{};
+    uint64_t end{};
+    uint64_t first_line{};
+};
+
+// Byte ranges of every lesson number in a lesson CSV. Stored next to the deck
+// as "<deck>.lmi" and tied to the stamp of the bytes it was built from.
+// Lines the loader skips are in `skipped` rather than under a lesson, and are
+// parsed again by every filtered load along with the lesson's own ranges, so
+// that a load through the index reports the same issues and line count as a
+// full parse.
+struct LessonIndex {
+    std::array<std::vector<LessonIndexRange>, 256> lessons;
+    std::vector<LessonIndexRange> skipped;
+    uint64_t line_count{};
+};
+
+// Adds `range` to `ranges`, extending the last range instead if `range`
+// starts where it ends. The loader calls this for each line as it parses, and
+// again to join the ranges of consecutive chunks.
+void add_index_range(std::vector<LessonIndexRange> &ranges, const LessonIndexRange &range);
+
+std::filesystem::path lesson_index_path(const std::filesystem::path &deck_path);
+
+// Writes the sidecar for `deck_path`. `stamp` is that of the mapping the index
+// was built from, not a fresh stat of the path: the file may have been saved
+// again since. Returns false if it could not be written.
+bool write_lesson_index(const LessonIndex &index, const std::filesystem::path &deck_path, const FileStamp &stamp);
+
+// Reads the sidecar for `deck_path`. Returns nothing if it is missing, corrupt
+// or was built for bytes with a different stamp than `stamp`, the mapping
+// about to be sliced.
+std::optional<LessonIndex> read_lesson_index(const std::filesystem::path &deck_path, const FileStamp &stamp);
+
+#endif //LEARNMON_LESSON_INDEX_H
@@ -0,0 +1,790 @@
+#include "lesson_server.h"
+
+#include <iostream>
+#include <print>
+
+#if defined(__linux__)
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include <csignal>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "lesson_engine.h"
+#include "rng.h"
+#include "shared_deck.h"
+
+namespace {
+
+// Longest line a client may send; longer ones end the session.
+constexpr size_t max_line_length = 4096;
+// The recap sent on connect lists at most this many rows.
+constexpr size_t max_recap_rows = 100;
+constexpr int max_events = 256;
+constexpr int listen_backlog = 4096;
+
+// Owns a file descriptor.
+class FileDescriptor {
+public:
+    FileDescriptor() = default;
+    explicit FileDescriptor(const int fd) : fd_(fd) {}
+    FileDescriptor(FileDescriptor &&other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+    FileDescriptor &operator=(FileDescriptor &&other) noexcept {
+        if (this != &other) {
+            reset();
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+    FileDescriptor(const FileDescriptor &) = delete;
+    FileDescriptor &operator=(const FileDescriptor &) = delete;
+    ~FileDescriptor() { reset(); }
+
+    [[nodiscard]] int get() const { return fd_; }
+    [[nodiscard]] bool valid() const { return fd_ >= 0; }
+    void reset() {
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+
+private:
+    int fd_ = -1;
+};
+
+// Visits every row of the deck once in a random order using O(1) state: rows
+// are taken as (offset + k * step) mod n with step coprime to n. A session on
+// a huge deck therefore needs no shuffled copy of the row numbers.
+class RowCursor {
+public:
+    RowCursor() = default;
+    RowCursor(const size_t rows, Rng &rng) : rows_(rows) {
+        if (rows_ == 0) {
+            return;
+        }
+        offset_ = std::uniform_int_distribution<size_t>(0, rows_ - 1)(rng);
+        step_ = 1;
+        if (rows_ > 2) {
+            std::uniform_int_distribution<size_t> steps(1, rows_ - 1);
+            do {
+                step_ = steps(rng);
+            } while (std::gcd(step_, rows_) != 1);
+        }
+    }
+
+    [[nodiscard]] bool done() const { return visited_ == rows_; }
+    uint32_t next() {
+        const auto row = static_cast<uint32_t>((offset_ + static_cast<unsigned __int128>(visited_) * step_) % rows_);
+        ++visited_;
+        return row;
+    }
+
+private:
+    size_t rows_ = 0;
+    size_t offset_ = 0;
+    size_t step_ = 1;
+    size_t visited_ = 0;
+};
+
+enum class WatchKind {
+    Listener,
+    Wakeup,
+    Signal,
+    Client
+};
+
+struct Session;
+
+// What an epoll event points at.
+struct Watch {
+    WatchKind kind;
+    int fd = -1;
+    Session *session = nullptr;
+};
+
+enum class SessionPhase {
+    Recap,    // the recap was sent; waiting for Enter
+    Playing,  // a lesson is in progress
+    Between,  // a spelling word is done; waiting for Enter
+    Finished
+};
+
+// One connected learner. The reactor owns the socket and the buffers; the
+// session's worker owns the lesson state. Each half is touched by one thread
+// only, and the session is freed by the reactor once the socket is closed and
+// no line is queued on or being handled by the worker. The deck snapshot is
+// pinned when the session connects and only read afterwards, so a session
+// ends on the deck it started with.
+struct Session {
+    DeckSnapshot deck;
+
+    // Reactor side.
+    FileDescriptor socket;
+    Watch watch{WatchKind::Client};
+    std::string input;
+    std::shared_ptr<const std::string> recap; // shared by the sessions of a snapshot
+    std::string_view greeting; // unsent part of the recap
+    std::string output;
+    size_t worker = 0; // all of the session's lines go to this worker, so they are handled in order
+    unsigned pending = 0; // lines handed to the worker and not yet answered
+    bool writing = false; // EPOLLOUT is armed
+    bool closing = false; // close once the output is flushed
+    bool eof = false; // the client shut down its side; answer what it sent, then close
+    bool closed = false;
+
+    // Worker side.
+    SessionPhase phase = SessionPhase::Recap;
+    LessonType lesson_type = LessonType::Spelling;
+    Rng rng;
+    RowCursor rows;
+    LessonEngine engine;
+};
+
+// A line from a session for the worker, or its answer for the reactor.
+struct SessionMessage {
+    Session *session = nullptr;
+    std::string text;
+    bool finished = false;
+};
+
+// Answers are handed back to the reactor through this queue; the eventfd
+// wakes it up.
+class Completions {
+public:
+    explicit Completions(const int wakeup_fd) : wakeup_fd_(wakeup_fd) {}
+
+    void push(SessionMessage message) {
+        bool was_empty;
+        {
+            std::lock_guard lock{mutex_};
+            was_empty = messages_.empty();
+            messages_.push_back(std::move(message));
+        }
+        if (was_empty) {
+            constexpr uint64_t one = 1;
+            [[maybe_unused]] const auto written = write(wakeup_fd_, &one, sizeof(one));
+        }
+    }
+
+    void take(std::vector<SessionMessage> &out) {
+        uint64_t count;
+        [[maybe_unused]] const auto read_bytes = read(wakeup_fd_, &count, sizeof(count));
+        std::lock_guard lock{mutex_};
+        out.swap(messages_);
+    }
+
+private:
+    int wakeup_fd_;
+    std::mutex mutex_;
+    std::vector<SessionMessage> messages_;
+};
+
+// Feeds one line from the learner to the session's flow and returns the text
+// to send back. In the recap and between words any line means Enter.
+SessionMessage advance_session(Session &session, const std::string_view line) {
+    const LessonStore &lessons = session.deck->lessons;
+    SessionMessage answer;
+    answer.session = &session;
+    std::string &out = answer.text;
+
+    const auto start_next = [&] {
+        if (session.rows.done()) {
+            out += "\nAll lessons done. Bye!\n";
+            session.phase = SessionPhase::Finished;
+            return;
+        }
+        const uint32_t row = session.rows.next();
+        session.engine.start(session.lesson_type, lessons[row], session.rng,
+                             session.lesson_type == LessonType::MultipleChoice
+                                 ? deck_distractors(*session.deck, row, session.rng)
+                                 : Distractors{});
+        const LessonScreen screen = session.engine.render();
+        std::format_to(std::back_inserter(out), "{}\n{}\n", screen.header, screen.prompt);
+        session.phase = SessionPhase::Playing;
+    };
+
+    switch (session.phase) {
+        case SessionPhase::Recap:
+            out += "\nStarting lesson...\n\n";
+            start_next();
+            break;
+        case SessionPhase::Between:
+            start_next();
+            break;
+        case SessionPhase::Playing: {
+            const LessonResult result = session.engine.submit(line);
+            if (!result.message.empty()) {
+                std::format_to(std::back_inserter(out), "{}\n", result.message);
+            }
+            if (result.status == LessonStatus::InProgress) {
+                const LessonScreen screen = session.engine.render();
+                if (screen.redraw) {
+                    std::format_to(std::back_inserter(out), "{}\n", screen.header);
+                }
+                std::format_to(std::back_inserter(out), "{}\n", screen.prompt);
+            } else if (session.lesson_type == LessonType::Spelling && !session.rows.done()) {
+                // Like the terminal frontend, spelling walks the whole deck
+                // and the other lessons play one word.
+                out += "\nPress Enter to continue...\n";
+                session.phase = SessionPhase::Between;
+            } else {
+                out += "\nBye!\n";
+                session.phase = SessionPhase::Finished;
+            }
+            break;
+        }
+        case SessionPhase::Finished:
+            break;
+    }
+    answer.finished = session.phase == SessionPhase::Finished;
+    return answer;
+}
+
+// Runs the lesson engines of the sessions assigned to it, one line at a time
+// and in arrival order.
+class Worker {
+public:
+    explicit Worker(Completions &completions)
+        : completions_(completions),
+          thread_([this](const std::stop_token &stop) { run(stop); }) {}
+
+    void push(SessionMessage line) {
+        {
+            std::lock_guard lock{mutex_};
+            lines_.push_back(std::move(line));
+        }
+        ready_.notify_one();
+    }
+
+private:
+    void run(const std::stop_token &stop) {
+        std::vector<SessionMessage> batch;
+        while (true) {
+            {
+                std::unique_lock lock{mutex_};
+                if (!ready_.wait(lock, stop, [this] { return !lines_.empty(); })) {
+                    return;
+                }
+                batch.swap(lines_);
+            }
+            for (SessionMessage &line : batch) {
+                completions_.push(advance_session(*line.session, line.text));
+            }
+            batch.clear();
+        }
+    }
+
+    Completions &completions_;
+    std::mutex mutex_;
+    std::condition_variable_any ready_;
+    std::vector<SessionMessage> lines_;
+    std::jthread thread_; // last, so it starts after and stops before the rest
+};
+
+std::string make_recap(const LessonStore &lessons) {
+    std::string greeting = "\nRecap\n\n";
+    const size_t shown = std::min(lessons.size(), max_recap_rows);
+    for (size_t row = 0; row < shown; ++row) {
+        const LessonView lesson = lessons[row];
+        std::format_to(std::back_inserter(greeting), "{} ({})- {}\n", lesson.word, lesson.description,
+                       lesson.origin_word);
+    }
+    if (shown < lessons.size()) {
+        std::format_to(std::back_inserter(greeting), "... and {} more.\n", lessons.size() - shown);
+    }
+    greeting += "\nPress Enter to start the lesson...\n";
+    return greeting;
+}
+
+// Splits "host:port" or "[v6]:port".
+bool split_address(const std::string_view address, std::string &host, std::string &port) {
+    const size_t colon = address.rfind(':');
+    if (colon == std::string_view::npos || colon + 1 == address.size()) {
+        return false;
+    }
+    std::string_view host_part = address.substr(0, colon);
+    if (host_part.size() >= 2 && host_part.front() == '[' && host_part.back() == ']') {
+        host_part = host_part.substr(1, host_part.size() - 2);
+    }
+    host = host_part;
+    port = address.substr(colon + 1);
+    return true;
+}
+
+FileDescriptor listen_tcp(const std::string_view address) {
+    std::string host;
+    std::string port;
+    if (!split_address(address, host, port)) {
+        std::println(std::cerr, "Error: Invalid address \"{}\", expected host:port.", address);
+        return {};
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo *found = nullptr;
+    if (const int error = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &found);
+        error != 0) {
+        std::println(std::cerr, "Error: Cannot resolve \"{}\": {}", address, gai_strerror(error));
+        return {};
+    }
+    const std::unique_ptr<addrinfo, decltype(&freeaddrinfo)> addresses{found, &freeaddrinfo};
+
+    int last_error = 0;
+    for (const addrinfo *ai = addresses.get(); ai != nullptr; ai = ai->ai_next) {
+        FileDescriptor fd{socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol)};
+        if (!fd.valid()) {
+            last_error = errno;
+            continue;
+        }
+        constexpr int on = 1;
+        setsockopt(fd.get(), SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (bind(fd.get(), ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd.get(), listen_backlog) == 0) {
+            return fd;
+        }
+        last_error = errno;
+    }
+    std::println(std::cerr, "Error: Cannot listen on {}: {}", address, std::strerror(last_error));
+    return {};
+}
+
+FileDescriptor listen_unix(const std::filesystem::path &path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.native().size() >= sizeof(addr.sun_path)) {
+        std::println(std::cerr, "Error: Socket path is too long: {}", path.string());
+        return {};
+    }
+    std::ranges::copy(path.native(), addr.sun_path);
+
+    // A socket file left behind by an earlier run would make bind() fail.
+    std::error_code ec;
+    if (std::filesystem::is_socket(path, ec)) {
+        std::filesystem::remove(path, ec);
+    }
+
+    FileDescriptor fd{socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)};
+    if (!fd.valid() || bind(fd.get(), reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(fd.get(), listen_backlog) != 0) {
+        std::println(std::cerr, "Error: Cannot listen on {}: {}", path.string(), std::strerror(errno));
+        return {};
+    }
+    return fd;
+}
+
+// Idle sessions cost one descriptor each, so lift the soft limit as far as allowed.
+void raise_descriptor_limit() {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+class LessonServer {
+public:
+    LessonServer(const SharedDeck &decks, const ServerOptions &options)
+        : decks_(decks), options_(options), rng_(options.seed.value_or(random_seed())) {}
+
+    ~LessonServer() {
+        for (const std::filesystem::path &path : unix_paths_) {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    }
+
+    int run() {
+        raise_descriptor_limit();
+
+        epoll_ = FileDescriptor{epoll_create1(EPOLL_CLOEXEC)};
+        wakeup_ = FileDescriptor{eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)};
+        if (!epoll_.valid() || !wakeup_.valid()) {
+            std::println(std::cerr, "Error: Cannot create the event loop: {}", std::strerror(errno));
+            return 1;
+        }
+
+        // Block the stop signals before any worker starts so that every thread
+        // inherits the mask and they are only seen through the signalfd.
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+        signal_ = FileDescriptor{signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC)};
+
+        if (!open_listeners()) {
+            return 1;
+        }
+        wakeup_watch_.fd = wakeup_.get();
+        signal_watch_.fd = signal_.get();
+        watch(wakeup_watch_, EPOLLIN);
+        watch(signal_watch_, EPOLLIN);
+
+        completions_ = std::make_unique<Completions>(wakeup_.get());
+        const unsigned worker_count =
+            options_.workers != 0 ? options_.workers : std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < worker_count; ++i) {
+            workers_.push_back(std::make_unique<Worker>(*completions_));
+        }
+        std::println(std::cerr, "Serving {} lessons with {} workers.", decks_.snapshot()->lessons.size(),
+                     worker_count);
+
+        loop();
+
+        workers_.clear();
+        std::println(std::cerr, "Shutting down after {} sessions ({} still connected).", accepted_,
+                     sessions_.size());
+        return 0;
+    }
+
+private:
+    bool open_listeners() {
+        std::vector<std::string> tcp_addresses = options_.tcp_addresses;
+        if (tcp_addresses.empty() && options_.unix_paths.empty()) {
+            tcp_addresses.emplace_back(ServerOptions::default_tcp_address);
+        }
+        for (const std::string &address : tcp_addresses) {
+            if (!add_listener(listen_tcp(address))) {
+                return false;
+            }
+            std::println(std::cerr, "Listening on {}", address);
+        }
+        for (const std::filesystem::path &path : options_.unix_paths) {
+            if (!add_listener(listen_unix(path))) {
+                return false;
+            }
+            unix_paths_.push_back(path);
+            std::println(std::cerr, "Listening on {}", path.string());
+        }
+        return true;
+    }
+
+    bool add_listener(FileDescriptor fd) {
+        if (!fd.valid()) {
+            return false;
+        }
+        auto &listener = listeners_.emplace_back(std::make_unique<Watch>(WatchKind::Listener, fd.get()));
+        listener_fds_.push_back(std::move(fd));
+        watch(*listener, EPOLLIN);
+        return true;
+    }
+
+    void watch(Watch &target, const uint32_t events, const int op = EPOLL_CTL_ADD) {
+        epoll_event event{};
+        event.events = events;
+        event.data.ptr = &target;
+        epoll_ctl(epoll_.get(), op, target.fd, &event);
+    }
+
+    void loop() {
+        std::array<epoll_event, max_events> events{};
+        while (true) {
+            const int count = epoll_wait(epoll_.get(), events.data(), max_events, -1);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::println(std::cerr, "Error: epoll_wait failed: {}", std::strerror(errno));
+                return;
+            }
+            for (int i = 0; i < count; ++i) {
+                Watch &target = *static_cast<Watch *>(events[i].data.ptr);
+                switch (target.kind) {
+                    case WatchKind::Listener: accept_sessions(target); break;
+                    case WatchKind::Wakeup: drain_completions(); break;
+                    case WatchKind::Signal: return;
+                    case WatchKind::Client: handle_client(*target.session, events[i].events); break;
+                }
+            }
+            // Sessions are freed between batches, as a later event of the same
+            // batch may still point at them.
+            for (const Session *session : released_) {
+                sessions_.erase(session);
+            }
+            released_.clear();
+        }
+    }
+
+    void accept_sessions(Watch &listener) {
+        while (true) {
+            FileDescriptor fd{accept4(listener.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)};
+            if (!fd.valid()) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                    // The pending connection stays readable, so the listener
+                    // is disarmed until a session closes and frees a descriptor.
+                    std::println(std::cerr, "Error: accept failed: {}", std::strerror(errno));
+                    watch(listener, 0, EPOLL_CTL_MOD);
+                    listeners_paused_ = true;
+                } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    std::println(std::cerr, "Error: accept failed: {}", std::strerror(errno));
+                }
+                return;
+            }
+            constexpr int on = 1;
+            setsockopt(fd.get(), IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+            auto session = std::make_unique<Session>();
+            session->socket = std::move(fd);
+            session->watch.fd = session->socket.get();
+            session->watch.session = session.get();
+            session->deck = decks_.snapshot();
+            session->recap = recap_for(session->deck);
+            session->greeting = *session->recap;
+            session->rng.seed(rng_());
+            session->lesson_type = resolve_lesson_type(options_.lesson_type, rng_);
+            session->engine = LessonEngine{options_.near_miss};
+            session->rows = RowCursor{session->deck->lessons.size(), session->rng};
+            session->worker = next_worker_;
+            next_worker_ = (next_worker_ + 1) % workers_.size();
+
+            Session &added = *session;
+            sessions_.emplace(&added, std::move(session));
+            ++accepted_;
+            watch(added.watch, EPOLLIN | EPOLLRDHUP);
+            flush(added);
+        }
+    }
+
+    // The recap is built once per snapshot rather than per session.
+    const std::shared_ptr<const std::string> &recap_for(const DeckSnapshot &deck) {
+        if (deck != recap_deck_) {
+            recap_deck_ = deck;
+            recap_ = std::make_shared<const std::string>(make_recap(deck->lessons));
+        }
+        return recap_;
+    }
+
+    void handle_client(Session &session, const uint32_t events) {
+        if ((events & EPOLLOUT) != 0) {
+            flush(session);
+        }
+        if (!session.closed && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0) {
+            read_lines(session);
+        }
+    }
+
+    void read_lines(Session &session) {
+        std::array<char, 4096> buffer; // NOLINT(*-member-init)
+        // Where the unfinished last line starts, so that a client sending no
+        // newline is cut off at max_line_length rather than buffered whole.
+        // Complete lines were taken out after the last read.
+        size_t line_start = 0;
+        while (true) {
+            const ssize_t n = recv(session.socket.get(), buffer.data(), buffer.size(), 0);
+            if (n > 0) {
+                if (!session.closing) {
+                    const std::string_view received{buffer.data(), static_cast<size_t>(n)};
+                    if (const size_t newline = received.rfind('\n'); newline != std::string_view::npos) {
+                        line_start = session.input.size() + newline + 1;
+                    }
+                    session.input += received;
+                    if (session.input.size() - line_start > max_line_length) {
+                        close_session(session);
+                        return;
+                    }
+                }
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            if (n < 0 || session.eof) {
+                close_session(session); // a socket error, or a hangup after the end of stream
+                return;
+            }
+            // End of stream: a client that writes its answers and shuts down
+            // its side still gets every reply. A last line without a newline
+            // counts as a line, and nothing more is read.
+            session.eof = true;
+            if (!session.input.empty() && !session.closing) {
+                session.input += '\n';
+            }
+            watch(session.watch, session.writing ? uint32_t{EPOLLOUT} : 0, EPOLL_CTL_MOD);
+            break;
+        }
+
+        size_t begin = 0;
+        for (size_t end; (end = session.input.find('\n', begin)) != std::string::npos; begin = end + 1) {
+            std::string_view line{session.input.data() + begin, end - begin};
+            if (line.ends_with('\r')) {
+                line.remove_suffix(1);
+            }
+            ++session.pending;
+            workers_[session.worker]->push(SessionMessage{&session, std::string{line}});
+        }
+        session.input.erase(0, begin);
+        if (session.input.empty()) {
+            // Let idle sessions give back a buffer grown by a long paste.
+            std::string{}.swap(session.input);
+        }
+        if (session.eof) {
+            close_when_answered(session);
+        }
+    }
+
+    // After the end of stream, the session closes once its last answer has
+    // come back from the worker and been sent.
+    void close_when_answered(Session &session) {
+        if (session.pending == 0) {
+            session.closing = true;
+            flush(session);
+        }
+    }
+
+    void drain_completions() {
+        completions_->take(answers_);
+        for (SessionMessage &answer : answers_) {
+            Session &session = *answer.session;
+            --session.pending;
+            if (session.closed) {
+                release_if_done(session);
+                continue;
+            }
+            session.output += answer.text;
+            if (answer.finished) {
+                session.closing = true;
+            }
+            if (session.eof) {
+                close_when_answered(session);
+            } else {
+                flush(session);
+            }
+        }
+        answers_.clear();
+    }
+
+    // Sends as much of the greeting and the output as the socket takes and
+    // arms EPOLLOUT for the rest.
+    void flush(Session &session) {
+        const auto send_some = [&](std::string_view &data) {
+            while (!data.empty()) {
+                const ssize_t n = send(session.socket.get(), data.data(), data.size(), MSG_NOSIGNAL);
+                if (n >= 0) {
+                    data.remove_prefix(static_cast<size_t>(n));
+                } else if (errno != EINTR) {
+                    return errno == EAGAIN || errno == EWOULDBLOCK;
+                }
+            }
+            return true;
+        };
+
+        if (!send_some(session.greeting)) {
+            close_session(session);
+            return;
+        }
+        if (session.greeting.empty() && !session.output.empty()) {
+            std::string_view rest = session.output;
+            if (!send_some(rest)) {
+                close_session(session);
+                return;
+            }
+            session.output.erase(0, session.output.size() - rest.size());
+            if (session.output.empty()) {
+                std::string{}.swap(session.output);
+            }
+        }
+
+        const bool drained = session.greeting.empty() && session.output.empty();
+        if (drained && session.closing) {
+            close_session(session);
+        } else if (drained == session.writing) {
+            session.writing = !drained;
+            const uint32_t reading = session.eof ? 0 : EPOLLIN | EPOLLRDHUP;
+            watch(session.watch, session.writing ? reading | EPOLLOUT : reading, EPOLL_CTL_MOD);
+        }
+    }
+
+    void close_session(Session &session) {
+        if (session.closed) {
+            return;
+        }
+        session.closed = true;
+        epoll_ctl(epoll_.get(), EPOLL_CTL_DEL, session.socket.get(), nullptr);
+        session.socket.reset();
+        release_if_done(session);
+        if (listeners_paused_) {
+            listeners_paused_ = false;
+            for (const std::unique_ptr<Watch> &listener : listeners_) {
+                watch(*listener, EPOLLIN, EPOLL_CTL_MOD);
+            }
+        }
+    }
+
+    // A closed session may still have lines with its worker; it is freed once
+    // the last answer comes back.
+    void release_if_done(const Session &session) {
+        if (session.closed && session.pending == 0) {
+            released_.push_back(&session);
+        }
+    }
+
+    const SharedDeck &decks_;
+    const ServerOptions &options_;
+    DeckSnapshot recap_deck_;
+    std::shared_ptr<const std::string> recap_;
+    Rng rng_;
+
+    FileDescriptor epoll_;
+    FileDescriptor wakeup_;
+    FileDescriptor signal_;
+    Watch wakeup_watch_{WatchKind::Wakeup};
+    Watch signal_watch_{WatchKind::Signal};
+    std::vector<FileDescriptor> listener_fds_;
+    std::vector<std::unique_ptr<Watch>> listeners_;
+    bool listeners_paused_ = false; // out of descriptors; re-armed when a session closes
+    std::vector<std::filesystem::path> unix_paths_;
+
+    std::unordered_map<const Session *, std::unique_ptr<Session>> sessions_;
+    std::vector<const Session *> released_;
+    size_t accepted_ = 0;
+    std::unique_ptr<Completions> completions_;
+    std::vector<SessionMessage> answers_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    size_t next_worker_ = 0; // sessions are dealt to the workers round-robin
+};
+
+} // namespace
+
+int run_lesson_server(const SharedDeck &decks, const ServerOptions &options) {
+    LessonServer server{decks, options};
+    return server.run();
+}
+
+#else
+
+int run_lesson_server(const SharedDeck &, const ServerOptions &) {
+    std::println(std::cerr, "Error: Server mode needs Linux (epoll).");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef LEARNMON_LESSON_SERVER_H
+#define LEARNMON_LESSON_SERVER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "lesson.h"
+#include "shared_deck.h"
+
+// Where and how to serve lessons. With no address at all the server listens
+// on default_tcp_address.
+struct ServerOptions {
+    static constexpr std::string_view default_tcp_address = "127.0.0.1:7878";
+
+    std::vector<std::string> tcp_addresses; // "host:port"; "[::1]:port" for IPv6 literals
+    std::vector<std::filesystem::path> unix_paths;
+    LessonType lesson_type = LessonType::Random; // Random picks one per session
+    unsigned workers = 0; // 0 = one per core
+    size_t near_miss = 0; // spelling answers accepted within this many edits, one per four letters
+    std::optional<uint64_t> seed; // seeds the session generators; random if unset
+};
+
+// Serves line-based lesson sessions until SIGINT or SIGTERM: one epoll reactor
+// thread accepts connections and moves bytes, and a pool of workers runs the
+// lesson engines. Every session gets the same flow as the terminal frontend
+// (recap, then the lessons) on the snapshot of `decks` that was current when
+// it connected; `decks` must outlive the call and may be republished from
+// any thread meanwhile. Returns the process exit code.
+int run_lesson_server(const SharedDeck &decks, const ServerOptions &options);
+
+#endif //LEARNMON_LESSON_SERVER_H
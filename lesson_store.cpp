@@ -0,0 +1,85 @@
+#include "lesson_store.h"
+
+#include <utility>
+
+#include "case_fold.h"
+#include "utf8.h"
+
+void LessonColumns::reserve(const size_t rows, const size_t word_char_count) {
+    lesson_numbers.reserve(rows);
+    word_chars.reserve(word_char_count);
+    folded_word_chars.reserve(word_char_count);
+    word_char_offsets.reserve(rows + 1);
+    for (size_t column = 0; column < lesson_field_count; ++column) {
+        offsets[column].reserve(rows);
+        sizes[column].reserve(rows);
+    }
+}
+
+void LessonColumns::push_back(const uint8_t lesson_number,
+                              const std::array<uint64_t, lesson_field_count> &field_offsets,
+                              const std::array<uint32_t, lesson_field_count> &field_sizes,
+                              const std::string_view word) {
+    lesson_numbers.push_back(lesson_number);
+    for (size_t column = 0; column < lesson_field_count; ++column) {
+        offsets[column].push_back(field_offsets[column]);
+        sizes[column].push_back(field_sizes[column]);
+    }
+
+    // Decode straight into the column: grow it by the byte count, which bounds
+    // the codepoint count, then trim to what was written.
+    const size_t decoded = word_chars.size();
+    word_chars.resize(decoded + word.size());
+    word_chars.resize(decoded + decode_utf8(word, word_chars.data() + decoded));
+    word_char_offsets.push_back(word_chars.size());
+
+    folded_word_chars.resize(word_chars.size());
+    fold_case(std::u32string_view{word_chars}.substr(decoded), std::span{folded_word_chars}.subspan(decoded));
+}
+
+LessonStore::LessonStore(LessonColumns columns, const std::string_view arena)
+    : owned_columns_(std::move(columns)), arena_(arena) {
+    bind_owned_columns();
+}
+
+LessonStore::LessonStore(LessonColumns columns, std::vector<char> arena)
+    : owned_columns_(std::move(columns)), owned_arena_(std::move(arena)),
+      arena_(owned_arena_.data(), owned_arena_.size()) {
+    bind_owned_columns();
+}
+
+LessonStore LessonStore::borrow(const std::span<const uint8_t> lesson_numbers,
+                                const std::array<std::span<const uint64_t>, lesson_field_count> &offsets,
+                                const std::array<std::span<const uint32_t>, lesson_field_count> &sizes,
+                                const std::string_view arena,
+                                const std::span<const uint64_t> word_char_offsets,
+                                const std::u32string_view word_chars,
+                                const std::u32string_view folded_word_chars) {
+    LessonStore store;
+    store.lesson_numbers_ = lesson_numbers;
+    store.offsets_ = offsets;
+    store.sizes_ = sizes;
+    store.arena_ = arena;
+    store.word_char_offsets_ = word_char_offsets;
+    store.word_chars_ = word_chars;
+    store.folded_word_chars_ = folded_word_chars;
+    return store;
+}
+
+size_t LessonStore::memory_usage() const {
+    return size() * (sizeof(uint8_t) + lesson_field_count * (sizeof(uint64_t) + sizeof(uint32_t))) +
+           owned_arena_.size() +
+           (owned_columns_.word_chars.size() + owned_columns_.folded_word_chars.size()) * sizeof(char32_t) +
+           owned_columns_.word_char_offsets.size() * sizeof(uint64_t);
+}
+
+void LessonStore::bind_owned_columns() {
+    lesson_numbers_ = owned_columns_.lesson_numbers;
+    for (size_t column = 0; column < lesson_field_count; ++column) {
+        offsets_[column] = owned_columns_.offsets[column];
+        sizes_[column] = owned_columns_.sizes[column];
+    }
+    word_char_offsets_ = owned_columns_.word_char_offsets;
+    word_chars_ = {owned_columns_.word_chars.data(), owned_columns_.word_chars.size()};
+    folded_word_chars_ = {owned_columns_.folded_word_chars.data(), owned_columns_.folded_word_chars.size()};
+}
@@ -0,0 +1,134 @@
+#ifndef LEARNMON_LESSON_STORE_H
+#define LEARNMON_LESSON_STORE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "lesson.h"
+
+enum class LessonField : size_t {
+    Word = 0,
+    Description = 1,
+    OriginWord = 2
+};
+
+inline constexpr size_t lesson_field_count = 3;
+
+// Growable columns of a LessonStore. Offsets point into the store's arena.
+// Words are decoded into `word_chars` and case-folded into `folded_word_chars`
+// as rows are added; row i's codepoints are at [word_char_offsets[i],
+// word_char_offsets[i + 1]) in both.
+struct LessonColumns {
+    std::vector<uint8_t> lesson_numbers;
+    std::array<std::vector<uint64_t>, lesson_field_count> offsets;
+    std::array<std::vector<uint32_t>, lesson_field_count> sizes;
+    std::vector<char32_t> word_chars;
+    std::vector<char32_t> folded_word_chars;
+    std::vector<uint64_t> word_char_offsets{0};
+
+    [[nodiscard]] size_t size() const { return lesson_numbers.size(); }
+    void reserve(size_t rows, size_t word_chars = 0);
+    // `word` is the text the word offset and size refer to.
+    void push_back(uint8_t lesson_number, const std::array<uint64_t, lesson_field_count> &field_offsets,
+                   const std::array<uint32_t, lesson_field_count> &field_sizes, std::string_view word);
+};
+
+// Struct-of-arrays deck storage: one array of lesson numbers, an offset and a
+// size array per text field, and a single arena holding all text. Words are
+// also kept decoded, as written and case-folded, in two codepoint arrays with
+// one shared offset array, so the games never re-split them. The columns and
+// the arena are either owned or borrowed from a mapped file, so a row costs no
+// allocation of its own: 45 bytes of metadata (1 for the lesson number, 36 for
+// the field offsets and sizes, 8 for the word offset) plus 8 bytes per
+// codepoint of its word. Rows are handed out as LessonView. Move-only, since
+// borrowed spans may point into owned vectors.
+class LessonStore {
+public:
+    LessonStore() = default;
+    // Owns the columns; the text stays in `arena`, which the caller keeps alive.
+    LessonStore(LessonColumns columns, std::string_view arena);
+    // Owns both the columns and the text.
+    LessonStore(LessonColumns columns, std::vector<char> arena);
+
+    // Borrows every column, e.g. from the sections of a mapped .lmb file.
+    // `word_char_offsets` has one entry more than there are rows; row i's
+    // codepoints are at [word_char_offsets[i], word_char_offsets[i + 1]) in
+    // both `word_chars` and `folded_word_chars`.
+    static LessonStore borrow(std::span<const uint8_t> lesson_numbers,
+                              const std::array<std::span<const uint64_t>, lesson_field_count> &offsets,
+                              const std::array<std::span<const uint32_t>, lesson_field_count> &sizes,
+                              std::string_view arena, std::span<const uint64_t> word_char_offsets,
+                              std::u32string_view word_chars, std::u32string_view folded_word_chars);
+
+    LessonStore(LessonStore &&) noexcept = default;
+    LessonStore &operator=(LessonStore &&) noexcept = default;
+    LessonStore(const LessonStore &) = delete;
+    LessonStore &operator=(const LessonStore &) = delete;
+    ~LessonStore() = default;
+
+    [[nodiscard]] size_t size() const { return lesson_numbers_.size(); }
+    [[nodiscard]] bool empty() const { return lesson_numbers_.empty(); }
+
+    [[nodiscard]] uint8_t lesson_number(const size_t row) const { return lesson_numbers_[row]; }
+    [[nodiscard]] std::string_view field(const size_t row, const LessonField field) const {
+        const auto column = static_cast<size_t>(field);
+        const uint64_t offset = offsets_[column][row];
+        return slice(arena_, offset, offset + sizes_[column][row]);
+    }
+    // The word of `row` as codepoints, decoded when the store was built.
+    [[nodiscard]] std::u32string_view word_chars(const size_t row) const {
+        return slice(word_chars_, word_char_offsets_[row], word_char_offsets_[row + 1]);
+    }
+    // The same codepoints, case-folded.
+    [[nodiscard]] std::u32string_view folded_word_chars(const size_t row) const {
+        return slice(folded_word_chars_, word_char_offsets_[row], word_char_offsets_[row + 1]);
+    }
+    [[nodiscard]] LessonView operator[](const size_t row) const {
+        return {lesson_number(row), field(row, LessonField::Word), field(row, LessonField::Description),
+                field(row, LessonField::OriginWord), word_chars(row), folded_word_chars(row)};
+    }
+
+    // All rows in order, as LessonView values.
+    [[nodiscard]] auto views() const {
+        return std::views::iota(size_t{0}, size()) | std::views::transform([this](const size_t row) {
+            return (*this)[row];
+        });
+    }
+
+    // Bytes used by the row metadata, the decoded words and, if owned, the arena.
+    [[nodiscard]] size_t memory_usage() const;
+
+private:
+    // [begin, end) of `text`, cut to fit. Offsets borrowed from a compiled
+    // deck are not checked when it is opened, so a corrupt one must give
+    // wrong text here rather than a read outside the mapping.
+    template<typename View>
+    static View slice(const View text, const uint64_t begin, const uint64_t end) {
+        const uint64_t first = std::min<uint64_t>(begin, text.size());
+        return text.substr(first, end > first ? end - first : 0);
+    }
+
+    void bind_owned_columns();
+
+    LessonColumns owned_columns_;
+    std::vector<char> owned_arena_;
+
+    std::span<const uint8_t> lesson_numbers_;
+    std::array<std::span<const uint64_t>, lesson_field_count> offsets_{};
+    std::array<std::span<const uint32_t>, lesson_field_count> sizes_{};
+    std::string_view arena_;
+
+    // Every word's codepoints back to back; row i spans offsets [i, i + 1).
+    std::span<const uint64_t> word_char_offsets_;
+    std::u32string_view word_chars_;
+    std::u32string_view folded_word_chars_;
+};
+
+#endif //LEARNMON_LESSON_STORE_H
@@ -1,424 +1,570 @@
-#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <iterator>
+#include <limits>
+#include <numeric>
 #include <optional>
 #include <print>
-#include <random>
 #include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
-enum class LessonType {
-    Random = 0,
-    Spelling = 1,
-    MultipleChoice = 2,
-    Hangman = 3
-};
+#include "batch.h"
+#include "compiled_deck.h"
+#include "deck.h"
+#include "deck_watcher.h"
+#include "lesson.h"
+#include "lesson_engine.h"
+#include "lesson_server.h"
+#include "review_log.h"
+#include "rng.h"
+#include "scheduler.h"
+#include "shared_deck.h"
+#include "terminal.h"
+
+void recap_lesson(Screen &screen, const LessonStore &lessons, std::span<const uint32_t> rows);
+LessonStatus serve_lesson(LessonEngine &engine);
+std::vector<uint32_t> take_due_rows(const LessonStore &lessons, std::span<const uint32_t> rows, Scheduler &scheduler,
+                                    std::span<const ReviewRecord> records, size_t limit);
+int64_t unix_now();
+
+bool parse_lesson_type(std::string_view arg, LessonType &lesson_type);
+bool parse_near_miss(std::string_view arg, size_t &near_miss);
+bool parse_seed(std::string_view arg, std::optional<uint64_t> &seed);
+
+int compile_deck(const std::filesystem::path &csv_path, const std::filesystem::path &lmb_path);
+int serve_deck(int argc, char *argv[]);
+int batch_deck(int argc, char *argv[]);
+
+Screen &console();
 
-struct LessonEntry {
-    uint8_t lesson_number{};
-    std::string word;
-    std::string description;
-    std::string origin_word;
-
-    LessonEntry(uint8_t num, std::string w, std::string d, std::string o)
-        : lesson_number(num), word(std::move(w)), description(std::move(d)), origin_word(std::move(o)) {}
-};
-
-void recap_lesson(const std::vector<LessonEntry> &lessons);
-bool serve_spelling_lesson(const LessonEntry &lesson);
-bool serve_multiple_choice_lesson(const LessonEntry &lesson, std::default_random_engine &rng);
-bool serve_hangman_lesson(const LessonEntry &lesson);
-std::vector<LessonEntry> read_lesson_from_file(const std::filesystem::path &path, std::optional<uint8_t> lesson_no);
-
-std::vector<std::string> split(std::string_view s, char delimiter);
-std::vector<std::string> split_word_to_chars(const std::string& s);
+int main(int argc, char *argv[]) {
+    if (argc >= 2 && std::string_view{argv[1]} == "compile") {
+        if (argc != 4) {
+            std::println(std::cerr, "Usage: {} compile \"deck.csv\" \"deck.lmb\"", argv[0]);
+            return 1;
+        }
+        return compile_deck(argv[2], argv[3]);
+    }
+    if (argc >= 2 && std::string_view{argv[1]} == "serve") {
+        return serve_deck(argc, argv);
+    }
+    if (argc >= 2 && std::string_view{argv[1]} == "batch") {
+        return batch_deck(argc, argv);
+    }
 
-inline void clear_screen();
+    // Options may appear anywhere; everything else is positional.
+    std::vector<std::string_view> args;
+    std::optional<size_t> sample_size;
+    bool similar = false;
+    size_t near_miss = 0;
+    std::optional<std::filesystem::path> review_log_path;
+    std::optional<uint64_t> seed;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--similar") {
+            similar = true;
+            continue;
+        }
+        if (arg == "--review-log") {
+            if (i + 1 >= argc) {
+                std::println(std::cerr, "Error: --review-log needs a file.");
+                return 1;
+            }
+            review_log_path = argv[++i];
+            continue;
+        }
+        if (arg == "--near-miss") {
+            if (!parse_near_miss(i + 1 < argc ? argv[++i] : "", near_miss)) {
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--seed") {
+            if (!parse_seed(i + 1 < argc ? argv[++i] : "", seed)) {
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--sample") {
+            const std::string_view count = i + 1 < argc ? argv[++i] : "";
+            size_t value = 0;
+            if (const auto [end, ec] = std::from_chars(count.data(), count.data() + count.size(), value);
+                ec != std::errc{} || value == 0) {
+                std::println(std::cerr, "Error: --sample needs a positive number of lessons, got \"{}\".", count);
+                return 1;
+            }
+            sample_size = value;
+            continue;
+        }
+        args.push_back(arg);
+    }
 
-int main(int argc, char *argv[]) {
-    clear_screen();
-    if (argc < 2) {
-        std::println(std::cerr, "Usage: {} \"filepath\" [lesson number] [lesson type]", argv[0]);
+    console().clear();
+    console().flush();
+    if (args.empty()) {
+        std::println(std::cerr, "Usage: {} \"filepath\" [lesson number] [lesson type] [--sample N] [--similar] [--near-miss N]"
+                     " [--review-log path] [--seed N]", argv[0]);
+        std::println(std::cerr, "       {} compile \"deck.csv\" \"deck.lmb\"", argv[0]);
+        std::println(std::cerr, "       {} serve \"filepath\" [lesson number] [lesson type] [--listen host:port]..."
+                     " [--unix path]... [--workers N] [--watch] [--similar] [--near-miss N]"
+                     " [--seed N]", argv[0]);
+        std::println(std::cerr, "       {} batch \"filepath\" \"script\" [lesson number] [lesson type] [--repeat N]"
+                     " [--similar] [--near-miss N] [--seed N]", argv[0]);
         return 1;
     }
 
-    const std::filesystem::path p = argv[1];
+    const std::filesystem::path p = args[0];
     if (!std::filesystem::exists(p)) {
         std::println(std::cerr, "File does not exist: {}", p.string());
         return 1;
     }
 
-    std::random_device r;
-    std::default_random_engine rng(r());
+    // With --seed, the lesson type, the sample and the order of the lessons
+    // are the same on every run.
+    Rng rng{seed.value_or(random_seed())};
     std::optional<uint8_t> lesson_no{};
     LessonType lesson_type = LessonType::Random;
 
-    try {
-        if (argc >= 3) {
-            const int temp = std::stoi(argv[2]);
-            if (temp < 0 || temp > 255) {
-                std::println(std::cerr, "Error: Lesson number must be between 0 and 255.");
-                return 1;
-            }
-            lesson_no = static_cast<uint8_t>(temp);
-            std::println("Preparing Lesson No {} ...", lesson_no.value());
-        }
-
-        if (argc >= 4) {
-            const int temp = std::stoi(argv[3]);
-            if (temp >= 0 && temp <= 3) {
-                lesson_type = static_cast<LessonType>(temp);
-            }
+    if (args.size() >= 2) {
+        const auto parsed = parse_lesson_number(args[1]);
+        if (!parsed.has_value()) {
+            std::println(std::cerr, "Error: Invalid lesson number \"{}\" (column {}): {}.", args[1],
+                         parsed.error().column, parse_error_message(parsed.error().reason));
+            return 1;
         }
+        lesson_no = parsed.value();
+        console().println("Preparing Lesson No {} ...", lesson_no.value());
+        console().flush();
+    }
 
-        if (lesson_type == LessonType::Random) {
-            std::uniform_int_distribution<> range(1, 3);
-            switch (range(rng)) {
-                case 1: lesson_type = LessonType::Spelling; break;
-                case 2: lesson_type = LessonType::MultipleChoice; break;
-                case 3: lesson_type = LessonType::Hangman; break;
-                default: std::unreachable();
-            }
-        }
-    } catch (const std::exception &e) {
-        std::println(std::cerr, "Error: Invalid number format. {}", e.what());
+    if (args.size() >= 3 && !parse_lesson_type(args[2], lesson_type)) {
         return 1;
     }
 
-    if (argc > 4) {
-        std::println(std::cerr, "Too many parameters.\nUsage: {} \"filepath\" [lesson number] [lesson type]", argv[0]);
+    lesson_type = resolve_lesson_type(lesson_type, rng);
+
+    if (args.size() > 3) {
+        std::println(std::cerr, "Too many parameters.\nUsage: {} \"filepath\" [lesson number] [lesson type] [--sample N] [--similar] [--near-miss N]"
+                     " [--review-log path] [--seed N]",
+                     argv[0]);
         return 1;
     }
 
-    auto lessons = read_lesson_from_file(p, lesson_no);
+    // CSV decks are sampled while streaming, so they never have to fit in
+    // memory; compiled decks are already mapped and are sampled by row below.
+    // With a review log, --sample instead caps how many due lessons are played.
+    auto deck = sample_size.has_value() && !is_compiled_deck(p) && !review_log_path.has_value()
+                    ? sample_deck(p, lesson_no, sample_size.value(), rng)
+                    : open_deck(p, lesson_no);
+    const LessonStore &lessons = deck.lessons;
+    print_load_report(deck.report, std::cerr);
 
     if (lessons.empty()) {
         std::println(std::cerr, "No lessons found or file is empty.");
         return 1;
     }
+    if (similar && lesson_type == LessonType::MultipleChoice) {
+        deck.similar_words = SimilarWords{lessons};
+    }
 
-    std::println("\nRecap\n");
-    recap_lesson(lessons);
-    std::println("\nPress Enter to start the lesson...\n");
-    std::cin.get();
-    clear_screen();
-
-    std::println("\nStarting lesson...\n");
-    std::ranges::shuffle(lessons, rng);
-
-    switch (lesson_type) {
-        case LessonType::Spelling: {
-            for (const auto &lesson : lessons) {
-                serve_spelling_lesson(lesson);
-                std::println("\nPress Enter to continue...\n");
-                std::cin.get();
-                clear_screen();
-            }
-            break;
+    // The store is immutable; select and shuffle row numbers instead of the rows.
+    std::vector<uint32_t> order(lessons.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::optional<ReviewLog> review_log;
+    if (review_log_path.has_value()) {
+        // Spaced repetition: play the lessons that are due, most overdue
+        // first; lessons never played before are due in random order.
+        const auto records = read_review_log(review_log_path.value());
+        review_log = ReviewLog::open(review_log_path.value());
+        if (!records.has_value() || !review_log.has_value()) {
+            std::println(std::cerr, "Error: Cannot open review log {}.", review_log_path->string());
+            return 1;
         }
-        case LessonType::MultipleChoice:
-            serve_multiple_choice_lesson(lessons.front(), rng);
-            break;
-        case LessonType::Hangman:
-            serve_hangman_lesson(lessons.front());
-            break;
-
-            case LessonType::Random: {
-                std::unreachable();
-                break;
+        Scheduler scheduler;
+        std::ranges::shuffle(order, rng);
+        order = take_due_rows(lessons, order, scheduler, records.value(),
+                              sample_size.value_or(std::numeric_limits<size_t>::max()));
+        if (order.empty()) {
+            if (const auto next = scheduler.next_due(0); next.has_value()) {
+                console().println("Nothing is due. The next lesson is due at {:%Y-%m-%d %H:%M} UTC.",
+                                  std::chrono::sys_seconds{std::chrono::seconds{next.value()}});
+                console().flush();
             }
+            return 0;
+        }
+    } else if (sample_size.has_value() && sample_size.value() < order.size()) {
+        std::ranges::shuffle(order, rng);
+        order.resize(sample_size.value());
     }
+    // Answers are graded like SM-2 qualities and appended to the log.
+    const auto record_review = [&](const uint32_t row, const LessonStatus status) {
+        if (!review_log.has_value() || status == LessonStatus::InProgress) {
+            return;
+        }
+        ReviewRecord record;
+        record.reviewed_at = unix_now();
+        record.card = card_id(lessons[row]);
+        record.grade = status == LessonStatus::Solved ? grade_solved : grade_failed;
+        if (!review_log->append(record)) {
+            std::println(std::cerr, "Error: Cannot write to review log {}.", review_log_path->string());
+        }
+    };
 
+    console().println("\nRecap\n");
+    recap_lesson(console(), lessons, order);
+    console().println("\nPress Enter to start the lesson...\n");
+    console().flush();
     std::cin.get();
+    console().clear();
 
-    return 0;
-}
-
-inline void clear_screen() {
-#if defined(_WIN32) || defined(_WIN64)
-    system("cls");
-#else
-    system("clear");
-#endif
-}
-
-std::vector<std::string> split(std::string_view s, const char delimiter) {
-    std::vector<std::string> tokens;
-    size_t start = 0, end = 0;
-    while ((end = s.find(delimiter, start)) != std::string_view::npos) {
-        tokens.emplace_back(s.substr(start, end - start));
-        start = end + 1;
+    console().println("\nStarting lesson...\n");
+    if (!review_log.has_value()) {
+        std::ranges::shuffle(order, rng);
     }
-    tokens.emplace_back(s.substr(start));
-    return tokens;
-}
 
-std::vector<std::string> split_word_to_chars(const std::string& s) {
-    std::vector<std::string> chars;
-    for (size_t i = 0; i < s.length(); ) {
-        if ((s[i] & 0x80) == 0x00) {
-            chars.push_back(s.substr(i, 1));
-            i += 1;
-        } else if ((s[i] & 0xE0) == 0xC0) {
-            chars.push_back(s.substr(i, 2));
-            i += 2;
-        } else if ((s[i] & 0xF0) == 0xE0) {
-            chars.push_back(s.substr(i, 3));
-            i += 3;
-        } else if ((s[i] & 0xF8) == 0xF0) {
-            chars.push_back(s.substr(i, 4));
-            i += 4;
-        } else {
-            // Malformed UTF-8, fall back to single byte
-            chars.push_back(s.substr(i, 1));
-            i += 1;
+    // Only multiple-choice lessons use distractors; looking them up for the
+    // others would also draw from `rng` and change what --seed replays.
+    LessonEngine engine{near_miss};
+    if (lesson_type == LessonType::Spelling) {
+        for (const uint32_t row : order) {
+            engine.start(lesson_type, lessons[row], rng);
+            record_review(row, serve_lesson(engine));
+            console().println("\nPress Enter to continue...\n");
+            console().flush();
+            std::cin.get();
+            console().clear();
         }
+    } else {
+        engine.start(lesson_type, lessons[order.front()], rng,
+                     lesson_type == LessonType::MultipleChoice ? deck_distractors(deck, order.front(), rng)
+                                                               : Distractors{});
+        record_review(order.front(), serve_lesson(engine));
     }
-    return chars;
-}
-
-std::vector<LessonEntry> read_lesson_from_file(const std::filesystem::path &path,
-                                                const std::optional<uint8_t> lesson_no) {
-    std::vector<LessonEntry> result;
-    result.reserve(100);
-
-    if (std::ifstream file{path}; file.is_open()) {
-        std::string line;
-        while (std::getline(file, line)) {
-            const auto words = split(line, ';');
 
-            if (words.size() < 4) {
-                std::println(std::cerr, "Warning: Skipping line with invalid format: {}", line);
-                continue;
-            }
+    console().flush();
+    std::cin.get();
 
-            try {
-                const int temp_lesson_no = std::stoi(words[0]);
+    return 0;
+}
 
-                if (temp_lesson_no < 0 || temp_lesson_no > 255) {
-                    std::println(std::cerr, "Invalid lesson number: {}!", words[0]);
-                    continue;
-                }
-                const auto current_lesson_no = static_cast<uint8_t>(temp_lesson_no);
+int compile_deck(const std::filesystem::path &csv_path, const std::filesystem::path &lmb_path) {
+    if (!std::filesystem::exists(csv_path)) {
+        std::println(std::cerr, "File does not exist: {}", csv_path.string());
+        return 1;
+    }
 
-                if (lesson_no.has_value() && current_lesson_no != lesson_no.value()) {
-                    continue;
-                }
+    const auto deck = load_deck(csv_path, std::nullopt);
+    print_load_report(deck.report, std::cerr);
+    if (deck.lessons.empty()) {
+        std::println(std::cerr, "No lessons found or file is empty.");
+        return 1;
+    }
 
-                result.emplace_back(current_lesson_no, words[1], words[2], words[3]);
-            } catch (const std::exception &e) {
-                std::println(std::cerr, "Error parsing lesson number on line: {}. {}", line, e.what());
-            }
-        }
+    if (!write_compiled_deck(deck, lmb_path)) {
+        std::println(std::cerr, "Error: Could not write compiled deck: {}", lmb_path.string());
+        return 1;
     }
-    return result;
+    std::println("Compiled {} lessons into {} ({} bytes).", deck.lessons.size(), lmb_path.string(),
+                 std::filesystem::file_size(lmb_path));
+    return 0;
 }
 
-void recap_lesson(const std::vector<LessonEntry> &lessons) {
-    for (const auto &lesson : lessons) {
-        std::println("{} ({})- {}", lesson.word, lesson.description, lesson.origin_word);
+// Parses a lesson type argument; numbers outside 0-3 leave `lesson_type` as is.
+bool parse_lesson_type(const std::string_view arg, LessonType &lesson_type) {
+    int temp = 0;
+    if (const auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), temp); ec != std::errc{}) {
+        std::println(std::cerr, "Error: Invalid lesson type \"{}\" (column {}): not a number.", arg,
+                     end - arg.data() + 1);
+        return false;
+    }
+    if (temp >= 0 && temp <= 3) {
+        lesson_type = static_cast<LessonType>(temp);
     }
+    return true;
 }
 
-bool serve_hangman_lesson(const LessonEntry &lesson) {
-    std::string target;
-    std::ranges::transform(lesson.word, std::back_inserter(target),
-                           [](unsigned char c) -> unsigned char { return std::tolower(c); });
-
-    std::vector<std::string> target_chars = split_word_to_chars(target);
-
-    std::vector<std::string> guess_chars;
-    guess_chars.resize(target_chars.size());
-    for (size_t i = 0; i < target_chars.size(); ++i) {
-        if (target_chars.at(i) == " ") {
-            guess_chars.at(i) = " ";
-        } else {
-            guess_chars.at(i) = "_";
-        }
+bool parse_seed(const std::string_view arg, std::optional<uint64_t> &seed) {
+    uint64_t value = 0;
+    if (const auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+        ec != std::errc{} || end != arg.data() + arg.size()) {
+        std::println(std::cerr, "Error: --seed needs a number, got \"{}\".", arg);
+        return false;
     }
+    seed = value;
+    return true;
+}
 
-    auto get_guess_string = [&]() {
-        std::string s;
-        for (const auto& c : guess_chars) {
-            s += c;
-        }
-        return s;
-    };
-
-    while (get_guess_string().contains('_')) {
-        clear_screen();
-        std::println("\nGuess the word!\n Current: {}", get_guess_string());
-
-        std::string input;
-        std::println("Enter a letter or a full word:");
-        std::getline(std::cin, input);
+bool parse_near_miss(const std::string_view arg, size_t &near_miss) {
+    if (const auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), near_miss);
+        ec != std::errc{} || end != arg.data() + arg.size()) {
+        std::println(std::cerr, "Error: --near-miss needs a number of edits, got \"{}\".", arg);
+        return false;
+    }
+    return true;
+}
 
-        if (input.empty()) {
+int serve_deck(const int argc, char *argv[]) {
+    std::vector<std::string_view> args;
+    ServerOptions options;
+    bool watch = false;
+    bool similar = false;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--watch" || arg == "--similar") {
+            (arg == "--watch" ? watch : similar) = true;
             continue;
         }
-
-        std::ranges::transform(input, input.begin(),
-                               [](unsigned char c) { return std::tolower(c); });
-
-        if (input == "quit") {
-            std::println("The word was: {} ", lesson.word);
-            return false;
+        if (arg == "--near-miss") {
+            if (!parse_near_miss(i + 1 < argc ? argv[++i] : "", options.near_miss)) {
+                return 1;
+            }
+            continue;
         }
-
-        if (input == target) {
-            std::println("\nYou found the word! \n{}\n{}\n{}", lesson.word, lesson.description, lesson.origin_word);
-            return true;
+        if (arg == "--seed") {
+            if (!parse_seed(i + 1 < argc ? argv[++i] : "", options.seed)) {
+                return 1;
+            }
+            continue;
         }
-
-        if (input.empty() > 0) {
-            bool found_char = false;
-            for (size_t i = 0; i < target_chars.size(); ++i) {
-                if (target_chars.at(i) == input) {
-                    guess_chars.at(i) = input;
-                    found_char = true;
-                }
+        if (arg == "--listen" || arg == "--unix" || arg == "--workers") {
+            if (i + 1 >= argc) {
+                std::println(std::cerr, "Error: {} needs a value.", arg);
+                return 1;
             }
-
-            if (!found_char) {
-                std::println("Wrong!");
+            const std::string_view value = argv[++i];
+            if (arg == "--listen") {
+                options.tcp_addresses.emplace_back(value);
+            } else if (arg == "--unix") {
+                options.unix_paths.emplace_back(value);
+            } else if (const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(),
+                                                              options.workers);
+                       ec != std::errc{} || end != value.data() + value.size()) {
+                std::println(std::cerr, "Error: --workers needs a number, got \"{}\".", value);
+                return 1;
             }
+            continue;
         }
-
-        if (!get_guess_string().contains("_")) {
-            std::println("\nYou found the word! \n{}\n{}\n{}", lesson.word, lesson.description, lesson.origin_word);
-            return true;
-        }
+        args.push_back(arg);
     }
 
-    return true;
-}
-
-bool serve_multiple_choice_lesson(const LessonEntry &lesson, std::default_random_engine &rng) {
-    std::vector<std::string> mongolian_letters = {"а", "б", "в", "г", "д", "е", "ё", "ж", "з", "и", "й", "к",
-                                                    "л", "м", "н", "о", "ө", "п", "р", "с", "т", "у", "ү", "ф", "х", "ц", "ч",
-                                                    "ш", "щ", "ъ", "ы", "ь", "э", "ю", "я" };
-
-    std::vector<std::string> choices;
-    choices.reserve(4);
-
-    auto target_chars = split_word_to_chars(lesson.word);
-    choices.push_back(lesson.word);
-    for (int i = 0; i < 3; ++i) {
-        std::string incorrect_word = lesson.word;
-        std::uniform_int_distribution<> how_many_changes(2, std::min(static_cast<int>(target_chars.size()), 4));
-        int amount_changes = how_many_changes(rng);
-        auto shuffled_target_chars = target_chars;
-        std::ranges::shuffle(shuffled_target_chars, rng);
-
-        while (amount_changes > 0) {
-            const auto& char_to_change_str = shuffled_target_chars.back();
-            shuffled_target_chars.pop_back();
-            size_t idx = incorrect_word.find(char_to_change_str);
-            if (idx == std::string::npos || char_to_change_str == " ") {
-                continue;
-            }
-
-            std::ranges::shuffle(mongolian_letters, rng);
-            const auto& new_letter = mongolian_letters.front();
+    if (args.empty() || args.size() > 3) {
+        std::println(std::cerr, "Usage: {} serve \"filepath\" [lesson number] [lesson type] [--listen host:port]..."
+                     " [--unix path]... [--workers N] [--watch] [--similar] [--near-miss N]"
+                     " [--seed N]", argv[0]);
+        return 1;
+    }
 
-            if (new_letter == char_to_change_str) {
-                continue;
-            }
+    const std::filesystem::path p = args[0];
+    if (!std::filesystem::exists(p)) {
+        std::println(std::cerr, "File does not exist: {}", p.string());
+        return 1;
+    }
 
-            incorrect_word.replace(idx, char_to_change_str.size(), new_letter);
-            amount_changes--;
+    std::optional<uint8_t> lesson_no{};
+    if (args.size() >= 2) {
+        const auto parsed = parse_lesson_number(args[1]);
+        if (!parsed.has_value()) {
+            std::println(std::cerr, "Error: Invalid lesson number \"{}\" (column {}): {}.", args[1],
+                         parsed.error().column, parse_error_message(parsed.error().reason));
+            return 1;
         }
-
-        choices.push_back(incorrect_word);
+        lesson_no = parsed.value();
+    }
+    if (args.size() >= 3 && !parse_lesson_type(args[2], options.lesson_type)) {
+        return 1;
     }
 
-    std::ranges::shuffle(choices, rng);
+    if (watch && is_compiled_deck(p)) {
+        std::println(std::cerr, "Error: --watch needs a CSV deck; recompile and restart for a new .lmb.");
+        return 1;
+    }
 
-    int correct_choice_idx = -1;
-    for (size_t i = 0; i < choices.size(); ++i) {
-        std::println("{}. {}", i + 1, choices[i]);
-        if (choices[i] == lesson.word) {
-            correct_choice_idx = static_cast<int>(i) + 1;
+    // A watched file is read rather than mapped: editors may rewrite it in
+    // place while sessions still use the old snapshot. Reloads build the
+    // same deck.
+    const auto load = [=] {
+        Deck deck = watch ? read_deck(p, lesson_no) : open_deck(p, lesson_no);
+        if (similar && !deck.lessons.empty()) {
+            deck.similar_words = SimilarWords{deck.lessons};
         }
+        return deck;
+    };
+    auto deck = std::make_shared<const Deck>(load());
+    print_load_report(deck->report, std::cerr);
+    if (deck->lessons.empty()) {
+        std::println(std::cerr, "No lessons found or file is empty.");
+        return 1;
     }
+    SharedDeck decks{std::move(deck)};
+    std::optional<DeckWatcher> watcher;
+    if (watch) {
+        watcher.emplace(decks, p, load);
+    }
+    return run_lesson_server(decks, options);
+}
 
-    while (true) {
-        std::string input;
-        std::println("\nHow do you spell {}?", lesson.origin_word);
-        std::println("Enter your choice (1-4):");
-        std::getline(std::cin, input);
-
-        if (input.empty()) {
+int batch_deck(const int argc, char *argv[]) {
+    std::vector<std::string_view> args;
+    BatchOptions options;
+    bool similar = false;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--similar") {
+            similar = true;
             continue;
         }
-
-        if (input == "quit") {
-            std::println("The word was: {} ", lesson.word);
-            return false;
+        if (arg == "--near-miss") {
+            if (!parse_near_miss(i + 1 < argc ? argv[++i] : "", options.near_miss)) {
+                return 1;
+            }
+            continue;
         }
-
-        try {
-            int choice = std::stoi(input);
-            if (choice < 1 || choice > 4) {
-                std::println("Invalid input! Please enter a number between 1 and 4.");
-                continue;
+        if (arg == "--seed") {
+            if (!parse_seed(i + 1 < argc ? argv[++i] : "", options.seed)) {
+                return 1;
             }
+            continue;
+        }
+        if (arg == "--repeat") {
+            const std::string_view value = i + 1 < argc ? argv[++i] : "";
+            if (const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.repeat);
+                ec != std::errc{} || end != value.data() + value.size()) {
+                std::println(std::cerr, "Error: --repeat needs a number, got \"{}\".", value);
+                return 1;
+            }
+            continue;
+        }
+        args.push_back(arg);
+    }
 
-            if (choice == correct_choice_idx) {
-                std::println("Correct! You found the word! \n{}\n{}\n{}", lesson.word, lesson.description, lesson.origin_word);
+    if (args.size() < 2 || args.size() > 4) {
+        std::println(std::cerr, "Usage: {} batch \"filepath\" \"script\" [lesson number] [lesson type] [--repeat N]"
+                     " [--similar] [--near-miss N] [--seed N]", argv[0]);
+        std::println(std::cerr, "The script has an answer per line or a JSON session per line; \"-\" reads stdin.");
+        return 1;
+    }
 
-                return true;
-            } else {
-                std::println("Wrong! The correct choice was {}!", correct_choice_idx);
-                std::println("The word was: {}\n{}\n{}", lesson.word, lesson.description, lesson.origin_word);
+    const std::filesystem::path p = args[0];
+    if (!std::filesystem::exists(p)) {
+        std::println(std::cerr, "File does not exist: {}", p.string());
+        return 1;
+    }
+    std::ifstream script_file;
+    if (args[1] != "-") {
+        script_file.open(std::filesystem::path{args[1]});
+        if (!script_file) {
+            std::println(std::cerr, "Error: Cannot open script {}.", args[1]);
+            return 1;
+        }
+    }
 
-                return false;
-            }
-        } catch (const std::exception& e) {
-            std::println("Invalid input! Please enter a number.");
+    std::optional<uint8_t> lesson_no{};
+    if (args.size() >= 3) {
+        const auto parsed = parse_lesson_number(args[2]);
+        if (!parsed.has_value()) {
+            std::println(std::cerr, "Error: Invalid lesson number \"{}\" (column {}): {}.", args[2],
+                         parsed.error().column, parse_error_message(parsed.error().reason));
+            return 1;
         }
+        lesson_no = parsed.value();
+    }
+    if (args.size() >= 4 && !parse_lesson_type(args[3], options.lesson_type)) {
+        return 1;
     }
 
-    return false;
+    Deck deck = open_deck(p, lesson_no);
+    print_load_report(deck.report, std::cerr);
+    if (deck.lessons.empty()) {
+        std::println(std::cerr, "No lessons found or file is empty.");
+        return 1;
+    }
+    if (similar) {
+        deck.similar_words = SimilarWords{deck.lessons};
+    }
+    return run_batch(deck, args[1] == "-" ? std::cin : script_file, options);
 }
 
-bool serve_spelling_lesson(const LessonEntry &lesson) {
-    std::string target;
-    std::ranges::transform(lesson.word, std::back_inserter(target),
-                           [](unsigned char c) -> unsigned char { return std::tolower(c); });
+// Everything the interactive frontend shows goes through this screen.
+Screen &console() {
+    static Screen screen = Screen::for_stdout();
+    return screen;
+}
 
-    std::println("How do you spell {}?", lesson.origin_word);
+// Lists the rows, a page at a time if they do not fit in the terminal.
+void recap_lesson(Screen &screen, const LessonStore &lessons, const std::span<const uint32_t> rows) {
+    page(screen, std::cin, rows.size(), [&](Screen &out, const size_t i) {
+        const LessonView lesson = lessons[rows[i]];
+        out.println("{} ({})- {}", lesson.word, lesson.description, lesson.origin_word);
+    });
+}
 
+// Terminal frontend for a started lesson: shows the screen, reads lines from
+// std::cin and prints the feedback until the lesson ends or input runs out.
+// Returns how the lesson ended; InProgress if input ran out first.
+LessonStatus serve_lesson(LessonEngine &engine) {
+    bool first = true;
     while (true) {
-        std::string input;
-        std::println("Your answer:");
-        std::getline(std::cin, input);
-
-        if (input.empty()) {
-            continue;
+        const LessonScreen screen = engine.render();
+        if (screen.redraw) {
+            console().clear();
+        }
+        if (first || screen.redraw) {
+            console().println("{}", screen.header);
+            first = false;
         }
+        console().println("{}", screen.prompt);
+        console().flush();
 
-        std::ranges::transform(input, input.begin(),
-                               [](unsigned char c) { return std::tolower(c); });
+        std::string input;
+        if (!std::getline(std::cin, input)) {
+            return LessonStatus::InProgress;
+        }
 
-        if (input == "hint") {
-            std::println("{}", lesson.description);
-            continue;
+        const LessonResult result = engine.submit(input);
+        if (!result.message.empty()) {
+            console().println("{}", result.message);
         }
+        if (result.status != LessonStatus::InProgress) {
+            return result.status;
+        }
+    }
+}
 
-        if (input == "quit") {
-            std::println("The correct spelling is: {} ", lesson.word);
-            return false;
+// Queues `rows` in the scheduler as new cards of user 0, in the given order,
+// replays the review log over them and takes up to `limit` that are due now.
+std::vector<uint32_t> take_due_rows(const LessonStore &lessons, const std::span<const uint32_t> rows,
+                                    Scheduler &scheduler, const std::span<const ReviewRecord> records,
+                                    const size_t limit) {
+    const int64_t now = unix_now();
+    std::unordered_map<uint64_t, uint32_t> card_rows;
+    card_rows.reserve(rows.size());
+    for (const uint32_t row : rows) {
+        const uint64_t card = card_id(lessons[row]);
+        if (card_rows.try_emplace(card, row).second) {
+            scheduler.add(0, card, now);
         }
+    }
+    scheduler.replay(records);
 
-        if (input == target) {
-            std::println("Correct! The word is: {}", lesson.word);
-            return true;
-        } else {
-            std::println("Incorrect. Try again.");
+    std::vector<uint32_t> due;
+    while (due.size() < limit) {
+        const auto card = scheduler.take_due(0, now);
+        if (!card.has_value()) {
+            break;
         }
+        due.push_back(card_rows.at(card.value()));
     }
+    return due;
+}
+
+int64_t unix_now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
 }
@@ -0,0 +1,115 @@
+#include "mapped_file.h"
+
+#include <utility>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::optional<MappedFile> MappedFile::open(const std::filesystem::path &path) {
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::nullopt;
+    }
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return std::nullopt;
+    }
+    FILETIME write_time{};
+    if (!GetFileTime(file, nullptr, nullptr, &write_time)) {
+        CloseHandle(file);
+        return std::nullopt;
+    }
+    const FileStamp stamp{static_cast<uint64_t>(file_size.QuadPart),
+                          static_cast<int64_t>((uint64_t{write_time.dwHighDateTime} << 32) |
+                                               write_time.dwLowDateTime)};
+    if (file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return MappedFile{nullptr, 0, stamp};
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return std::nullopt;
+    }
+
+    const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr) {
+        return std::nullopt;
+    }
+    return MappedFile{static_cast<const char *>(data), static_cast<size_t>(file_size.QuadPart), stamp};
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return std::nullopt;
+    }
+#if defined(__APPLE__)
+    const timespec mtime = st.st_mtimespec;
+#else
+    const timespec mtime = st.st_mtim;
+#endif
+    const FileStamp stamp{static_cast<uint64_t>(st.st_size),
+                          static_cast<int64_t>(mtime.tv_sec) * 1'000'000'000 + mtime.tv_nsec};
+    if (st.st_size == 0) {
+        close(fd);
+        return MappedFile{nullptr, 0, stamp};
+    }
+
+    const auto size = static_cast<size_t>(st.st_size);
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return std::nullopt;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    return MappedFile{static_cast<const char *>(data), size, stamp};
+#endif
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)), stamp_(other.stamp_) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        stamp_ = other.stamp_;
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+void MappedFile::release() {
+    if (data_ == nullptr) {
+        return;
+    }
+#if defined(_WIN32) || defined(_WIN64)
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<char *>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
@@ -0,0 +1,46 @@
+#ifndef LEARNMON_MAPPED_FILE_H
+#define LEARNMON_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+// Size and last modification time of a file, for telling whether it changed.
+struct FileStamp {
+    uint64_t size{};
+    int64_t mtime{}; // nanoseconds since the epoch (100 ns ticks since 1601 on Windows)
+
+    bool operator==(const FileStamp &) const = default;
+};
+
+// Read-only memory mapping of a whole file. Move-only; the mapping is released
+// when the object is destroyed, so views into it must not outlive it.
+class MappedFile {
+public:
+    static std::optional<MappedFile> open(const std::filesystem::path &path);
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    [[nodiscard]] std::string_view view() const { return {data_, size_}; }
+    [[nodiscard]] const char *data() const { return data_; }
+    [[nodiscard]] size_t size() const { return size_; }
+    // Taken from the handle that was mapped, so it describes the mapped bytes
+    // even if the file is replaced or rewritten afterwards.
+    [[nodiscard]] const FileStamp &stamp() const { return stamp_; }
+
+private:
+    MappedFile(const char *data, size_t size, const FileStamp &stamp) : data_(data), size_(size), stamp_(stamp) {}
+    void release();
+
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    FileStamp stamp_;
+};
+
+#endif //LEARNMON_MAPPED_FILE_H
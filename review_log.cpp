@@ -0,0 +1,80 @@
+#include "review_log.h"
+
+#include <system_error>
+
+namespace {
+
+bool valid_header(const LmrHeader &header) {
+    return header.magic == lmr_magic && header.version == lmr_version && header.byte_order == lmr_byte_order_mark;
+}
+
+} // namespace
+
+std::optional<ReviewLog> ReviewLog::open(const std::filesystem::path &path) {
+    std::error_code ec;
+    const auto size = std::filesystem::exists(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+    if (ec) {
+        return std::nullopt;
+    }
+
+    if (size > 0) {
+        LmrHeader header;
+        std::ifstream in{path, std::ios::binary};
+        if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) || !valid_header(header)) {
+            return std::nullopt;
+        }
+        // Drop a record torn by a crash, so that new records stay aligned.
+        if (const auto torn = (size - sizeof(LmrHeader)) % sizeof(ReviewRecord); torn != 0) {
+            std::filesystem::resize_file(path, size - torn, ec);
+            if (ec) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    std::ofstream out{path, std::ios::binary | std::ios::app};
+    if (!out) {
+        return std::nullopt;
+    }
+    if (size == 0) {
+        LmrHeader header;
+        header.magic = lmr_magic;
+        header.version = lmr_version;
+        header.byte_order = lmr_byte_order_mark;
+        if (!out.write(reinterpret_cast<const char *>(&header), sizeof(header)).flush()) {
+            return std::nullopt;
+        }
+    }
+    return ReviewLog{std::move(out)};
+}
+
+bool ReviewLog::append(const ReviewRecord &record) {
+    return static_cast<bool>(out_.write(reinterpret_cast<const char *>(&record), sizeof(record)).flush());
+}
+
+std::optional<std::vector<ReviewRecord>> read_review_log(const std::filesystem::path &path) {
+    std::vector<ReviewRecord> records;
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        return records;
+    }
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    if (size == 0) {
+        return records;
+    }
+
+    std::ifstream in{path, std::ios::binary};
+    LmrHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) || !valid_header(header)) {
+        return std::nullopt;
+    }
+    records.resize((size - sizeof(LmrHeader)) / sizeof(ReviewRecord));
+    if (!in.read(reinterpret_cast<char *>(records.data()),
+                 static_cast<std::streamsize>(records.size() * sizeof(ReviewRecord)))) {
+        return std::nullopt;
+    }
+    return records;
+}
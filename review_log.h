@@ -0,0 +1,61 @@
+#ifndef LEARNMON_REVIEW_LOG_H
+#define LEARNMON_REVIEW_LOG_H
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Review log (.lmr) layout, all integers in native byte order:
+//
+//   LmrHeader
+//   ReviewRecord records[]
+//
+// The file is only ever appended to, one whole record per write, so a crash
+// can at worst leave a partial record at the end; it is cut off when the log
+// is next opened for appending and skipped when reading.
+inline constexpr std::array<char, 4> lmr_magic = {'L', 'M', 'R', '\0'};
+inline constexpr uint32_t lmr_version = 1;
+inline constexpr uint32_t lmr_byte_order_mark = 0x01020304;
+
+struct LmrHeader {
+    std::array<char, 4> magic{};
+    uint32_t version{};
+    uint32_t byte_order{};
+    uint32_t reserved{};
+};
+
+// One answered lesson.
+struct ReviewRecord {
+    int64_t reviewed_at{}; // seconds since the Unix epoch
+    uint64_t card{}; // card_id() of the word
+    uint32_t user{};
+    uint8_t grade{}; // SM-2 quality: 0 (blackout) to 5 (perfect)
+    std::array<uint8_t, 3> reserved{};
+};
+
+static_assert(sizeof(LmrHeader) == 16);
+static_assert(sizeof(ReviewRecord) == 24);
+
+// Appending side of a review log; creates the file if it does not exist.
+class ReviewLog {
+public:
+    static std::optional<ReviewLog> open(const std::filesystem::path &path);
+
+    // Writes and flushes one record. Returns false if the write failed.
+    bool append(const ReviewRecord &record);
+
+private:
+    explicit ReviewLog(std::ofstream out) : out_(std::move(out)) {}
+
+    std::ofstream out_;
+};
+
+// Every whole record of the log at `path`, oldest first; empty if the file
+// does not exist, std::nullopt if it is not a review log.
+std::optional<std::vector<ReviewRecord>> read_review_log(const std::filesystem::path &path);
+
+#endif //LEARNMON_REVIEW_LOG_H
@@ -0,0 +1,64 @@
+#ifndef LEARNMON_RNG_H
+#define LEARNMON_RNG_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+// xoshiro256** (Blackman and Vigna): 256 bits of state and a handful of
+// shifts, rotations and multiplies per 64-bit output. Much faster than
+// libc++'s default engine, a 31-bit minimal-standard LCG that needs two calls
+// for every draw from a 64-bit range, and it passes BigCrush. The seed is
+// expanded to the full state with SplitMix64, so small and similar seeds give
+// unrelated streams. Meets UniformRandomBitGenerator, so the standard
+// distributions and std::ranges::shuffle take it.
+class Xoshiro256StarStar {
+public:
+    using result_type = uint64_t;
+
+    static constexpr result_type default_seed = 0x4c6561726e4d6f6e; // "LearnMon"
+
+    explicit Xoshiro256StarStar(const uint64_t seed = default_seed) { this->seed(seed); }
+
+    void seed(uint64_t seed) {
+        for (uint64_t &word : state_) {
+            seed += 0x9e3779b97f4a7c15;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const uint64_t result = std::rotl(state_[1] * 5, 7) * 9;
+        const uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = std::rotl(state_[3], 45);
+        return result;
+    }
+
+private:
+    std::array<uint64_t, 4> state_{};
+};
+
+// The generator behind every shuffle and random pick; all of them take an
+// Rng &, so another engine only has to be swapped in here.
+using Rng = Xoshiro256StarStar;
+
+// A fresh seed from std::random_device, for runs without --seed.
+inline uint64_t random_seed() {
+    std::random_device device;
+    return (uint64_t{device()} << 32) ^ device();
+}
+
+#endif //LEARNMON_RNG_H
@@ -0,0 +1,136 @@
+#include "scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace {
+
+constexpr int64_t seconds_per_day = 24 * 60 * 60;
+constexpr int min_ease_permille = 1300;
+
+// SM-2: a remembered card's interval grows from 1 to 6 days and then by its
+// ease factor; a forgotten one starts over. The ease factor follows the
+// quality of every review.
+void apply_review(CardState &state, const ReviewRecord &record) {
+    const int quality = std::min<int>(record.grade, 5);
+    if (quality >= 3) {
+        if (state.repetitions == 0) {
+            state.interval_days = 1;
+        } else if (state.repetitions == 1) {
+            state.interval_days = 6;
+        } else {
+            state.interval_days = static_cast<uint32_t>(
+                std::lround(state.interval_days * (static_cast<double>(state.ease_permille) / 1000.0)));
+        }
+        ++state.repetitions;
+    } else {
+        // Forgotten: start over, and see it again later in the session.
+        state.repetitions = 0;
+        state.interval_days = 0;
+    }
+    // EF' = EF + (0.1 - (5 - q) * (0.08 + (5 - q) * 0.02)), in thousandths.
+    const int miss = 5 - quality;
+    state.ease_permille = static_cast<uint16_t>(
+        std::max(min_ease_permille, state.ease_permille + 100 - miss * (80 + miss * 20)));
+    state.due = record.reviewed_at +
+                (state.interval_days == 0 ? Scheduler::relearn_delay_seconds
+                                          : state.interval_days * seconds_per_day);
+}
+
+} // namespace
+
+uint64_t card_id(const LessonView &lesson) {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const char c : lesson.word) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+void Scheduler::add(const uint32_t user, const uint64_t card, const int64_t now) {
+    UserCards &cards = users_[user];
+    if (const auto [it, inserted] = cards.states.try_emplace(card); inserted) {
+        it->second.due = now;
+        push(cards, card, it->second);
+    }
+}
+
+void Scheduler::review(const ReviewRecord &record) {
+    if (CardState *state = find(record.user, record.card)) {
+        apply_review(*state, record);
+        push(users_.at(record.user), record.card, *state);
+    }
+}
+
+void Scheduler::replay(const std::span<const ReviewRecord> records) {
+    for (const ReviewRecord &record : records) {
+        if (CardState *state = find(record.user, record.card)) {
+            apply_review(*state, record);
+        }
+    }
+    // Rebuild every queue from the states, keeping each card's place among
+    // cards due at the same time.
+    for (auto &[user, cards] : users_) {
+        cards.heap.clear();
+        for (const auto &[card, state] : cards.states) {
+            cards.heap.push_back({state.due, state.queued, card});
+        }
+        std::ranges::make_heap(cards.heap, std::greater{});
+    }
+}
+
+std::optional<uint64_t> Scheduler::take_due(const uint32_t user, const int64_t now) {
+    const auto it = users_.find(user);
+    if (it == users_.end()) {
+        return std::nullopt;
+    }
+    UserCards &cards = it->second;
+    drop_stale(cards);
+    if (cards.heap.empty() || cards.heap.front().due > now) {
+        return std::nullopt;
+    }
+    std::ranges::pop_heap(cards.heap, std::greater{});
+    const uint64_t card = cards.heap.back().card;
+    cards.heap.pop_back();
+    return card;
+}
+
+std::optional<int64_t> Scheduler::next_due(const uint32_t user) {
+    const auto it = users_.find(user);
+    if (it == users_.end()) {
+        return std::nullopt;
+    }
+    drop_stale(it->second);
+    if (it->second.heap.empty()) {
+        return std::nullopt;
+    }
+    return it->second.heap.front().due;
+}
+
+const CardState *Scheduler::state(const uint32_t user, const uint64_t card) const {
+    const auto it = users_.find(user);
+    if (it == users_.end()) {
+        return nullptr;
+    }
+    const auto found = it->second.states.find(card);
+    return found != it->second.states.end() ? &found->second : nullptr;
+}
+
+CardState *Scheduler::find(const uint32_t user, const uint64_t card) {
+    return const_cast<CardState *>(state(user, card));
+}
+
+void Scheduler::push(UserCards &cards, const uint64_t card, CardState &state) {
+    state.queued = next_order_++;
+    cards.heap.push_back({state.due, state.queued, card});
+    std::ranges::push_heap(cards.heap, std::greater{});
+}
+
+void Scheduler::drop_stale(UserCards &cards) {
+    while (!cards.heap.empty() && cards.states.at(cards.heap.front().card).queued != cards.heap.front().order) {
+        std::ranges::pop_heap(cards.heap, std::greater{});
+        cards.heap.pop_back();
+    }
+}
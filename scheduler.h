@@ -0,0 +1,89 @@
+#ifndef LEARNMON_SCHEDULER_H
+#define LEARNMON_SCHEDULER_H
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "lesson.h"
+#include "review_log.h"
+
+// Stable identity of a word across edits and recompiles of its deck: a
+// 64-bit FNV-1a hash of its text. Rows move, words do not.
+uint64_t card_id(const LessonView &lesson);
+
+// SM-2 quality recorded for a lesson that was solved or failed.
+inline constexpr uint8_t grade_solved = 4;
+inline constexpr uint8_t grade_failed = 1;
+
+// Spacing of one card for one user, as in SuperMemo 2.
+struct CardState {
+    int64_t due{}; // seconds since the Unix epoch
+    uint32_t interval_days{};
+    uint16_t repetitions{}; // successful reviews in a row
+    uint16_t ease_permille = 2500; // the ease factor, 2.5, in thousandths
+    uint64_t queued{}; // which queue entry of the card is current
+};
+
+// Spaced-repetition queue of many users' cards. Each user's cards sit in a
+// binary min-heap keyed on due time, so taking the next due card and putting
+// a reviewed one back are O(log n). A review pushes the card again rather
+// than moving it; the entry left behind is stale and dropped when it
+// reaches the top.
+class Scheduler {
+public:
+    static constexpr int64_t relearn_delay_seconds = 10 * 60;
+
+    // Adds a card that has never been reviewed, due at `now`; cards added
+    // with the same due time come out in the order they were added. Does
+    // nothing if the user already has the card.
+    void add(uint32_t user, uint64_t card, int64_t now);
+
+    // Applies a review with SM-2 and puts the card back in its user's queue.
+    // Reviews of cards that were never added are ignored, so replaying a
+    // whole log only schedules the cards of the current deck.
+    void review(const ReviewRecord &record);
+
+    // review() for every record, oldest first, with the queues rebuilt once
+    // at the end instead of growing by a stale entry per record. Meant for
+    // loading a log before any card is taken.
+    void replay(std::span<const ReviewRecord> records);
+
+    // Takes the user's card that has been due the longest, if any is due at
+    // `now`. It leaves the queue until it is reviewed.
+    std::optional<uint64_t> take_due(uint32_t user, int64_t now);
+
+    // When the user's next card is due, if they have any in the queue.
+    std::optional<int64_t> next_due(uint32_t user);
+
+    [[nodiscard]] const CardState *state(uint32_t user, uint64_t card) const;
+
+private:
+    struct Entry {
+        int64_t due;
+        uint64_t order; // ties on due time go to the card queued first
+        uint64_t card;
+
+        bool operator>(const Entry &other) const {
+            return due != other.due ? due > other.due : order > other.order;
+        }
+    };
+
+    struct UserCards {
+        std::unordered_map<uint64_t, CardState> states;
+        std::vector<Entry> heap; // std::push_heap/std::pop_heap with std::greater
+    };
+
+    // Looks up the user's card; nullptr if it was never added.
+    CardState *find(uint32_t user, uint64_t card);
+    void push(UserCards &cards, uint64_t card, CardState &state);
+    // Pops the stale entries off the top of the user's heap.
+    static void drop_stale(UserCards &cards);
+
+    std::unordered_map<uint32_t, UserCards> users_;
+    uint64_t next_order_ = 0;
+};
+
+#endif //LEARNMON_SCHEDULER_H
@@ -0,0 +1,34 @@
+#include "shared_deck.h"
+
+#include <thread>
+#include <utility>
+
+SharedDeck::SharedDeck(DeckSnapshot deck) : current_(new DeckSnapshot{std::move(deck)}) {}
+
+SharedDeck::~SharedDeck() {
+    delete current_.load();
+}
+
+DeckSnapshot SharedDeck::snapshot() const {
+    // Announce the read before loading the slot; publish() swaps the slot
+    // first and then waits for the count to drop, so the slot loaded here
+    // cannot be freed under us. Both sides need sequential consistency.
+    readers_.fetch_add(1);
+    DeckSnapshot deck = *current_.load();
+    readers_.fetch_sub(1);
+    return deck;
+}
+
+DeckSnapshot SharedDeck::publish(DeckSnapshot deck) {
+    std::lock_guard lock{publish_mutex_};
+    DeckSnapshot *previous = current_.exchange(new DeckSnapshot{std::move(deck)});
+    // Readers only stay in snapshot() for a reference count increment, so
+    // this grace period is short; new readers already see the new slot.
+    while (readers_.load() != 0) {
+        std::this_thread::yield();
+    }
+    DeckSnapshot old = std::move(*previous);
+    delete previous;
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    return old;
+}
@@ -0,0 +1,46 @@
+#ifndef LEARNMON_SHARED_DECK_H
+#define LEARNMON_SHARED_DECK_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "deck.h"
+
+// An immutable loaded deck. Whoever holds a snapshot keeps its rows and
+// mapping alive, so a session can finish on the deck it started with while
+// newer snapshots are published.
+using DeckSnapshot = std::shared_ptr<const Deck>;
+
+// The current deck snapshot, shared by any number of reader threads and
+// replaced with publish(). Readers never wait: snapshot() is a few atomic
+// operations and a reference count increment. publish() is serialised and
+// waits while readers are inside snapshot().
+class SharedDeck {
+public:
+    explicit SharedDeck(DeckSnapshot deck);
+    SharedDeck(const SharedDeck &) = delete;
+    SharedDeck &operator=(const SharedDeck &) = delete;
+    ~SharedDeck();
+
+    [[nodiscard]] DeckSnapshot snapshot() const;
+
+    // Makes `deck` the snapshot returned from now on and returns the previous
+    // one, which lives on for as long as someone holds it.
+    DeckSnapshot publish(DeckSnapshot deck);
+
+    // Number of publish() calls so far.
+    [[nodiscard]] uint64_t generation() const { return generation_.load(std::memory_order_relaxed); }
+
+private:
+    // The snapshot is reached through a heap slot so that readers can copy
+    // the shared_ptr without a lock; a slot is freed once no reader can still
+    // be copying from it.
+    std::atomic<DeckSnapshot *> current_;
+    mutable std::atomic<uint32_t> readers_{0};
+    std::atomic<uint64_t> generation_{0};
+    std::mutex publish_mutex_;
+};
+
+#endif //LEARNMON_SHARED_DECK_H
@@ -0,0 +1,224 @@
+#include "similar_words.h"
+
+#include <algorithm>
+#include <random>
+
+namespace {
+
+// Markers around every word, outside the Unicode range so no text contains them.
+constexpr char32_t word_begin = 0x110000;
+constexpr char32_t word_end = 0x110001;
+
+// Occurrences of a bigram beyond this many in one word share the last token.
+constexpr uint32_t max_occurrences = 4;
+
+// Distance checks per lookup; bounds the time spent on very common bigrams.
+constexpr size_t candidate_budget = 1024;
+
+uint64_t bigram_key(const char32_t first, const char32_t second) {
+    return (uint64_t{first} << 32) | second;
+}
+
+// Calls `f(key, occurrence)` for each bigram of the padded word.
+template<typename F>
+void for_each_bigram(const std::u32string_view word, F &&f) {
+    std::vector<uint64_t> seen;
+    seen.reserve(word.size() + 1);
+    char32_t previous = word_begin;
+    for (size_t i = 0; i <= word.size(); ++i) {
+        const char32_t current = i < word.size() ? word[i] : word_end;
+        const uint64_t key = bigram_key(previous, current);
+        const auto occurrence = static_cast<uint32_t>(std::ranges::count(seen, key));
+        seen.push_back(key);
+        f(key, std::min(occurrence, max_occurrences - 1));
+        previous = current;
+    }
+}
+
+// bounded_edit_distance with the caller's scratch table, so that lookups
+// checking thousands of candidates do not allocate for each.
+size_t bounded_edit_distance(const std::u32string_view a, const std::u32string_view b, const size_t limit,
+                             std::vector<size_t> &table) {
+    const size_t n = a.size();
+    const size_t m = b.size();
+    const size_t over = limit + 1;
+    if ((n > m ? n - m : m - n) > limit) {
+        return over;
+    }
+
+    // Three rows of the table, for the current row and the two before it
+    // (transpositions look two rows back). Cells outside the band stay `over`.
+    table.assign(3 * (m + 1), over);
+    size_t *two_back = table.data();
+    size_t *previous = two_back + (m + 1);
+    size_t *current = previous + (m + 1);
+    for (size_t j = 0; j <= std::min(m, limit); ++j) {
+        previous[j] = j;
+    }
+
+    for (size_t i = 1; i <= n; ++i) {
+        std::fill(current, current + m + 1, over);
+        current[0] = i <= limit ? i : over;
+        size_t row_min = current[0];
+        const size_t first = i > limit ? i - limit : 1;
+        const size_t last = std::min(m, i + limit);
+        for (size_t j = first; j <= last; ++j) {
+            size_t cell = std::min({previous[j - 1] + (a[i - 1] != b[j - 1] ? 1 : 0), previous[j] + 1,
+                                    current[j - 1] + 1});
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                cell = std::min(cell, two_back[j - 2] + 1);
+            }
+            current[j] = std::min(cell, over);
+            row_min = std::min(row_min, current[j]);
+        }
+        if (row_min > limit) {
+            return over;
+        }
+        std::swap(two_back, previous);
+        std::swap(previous, current);
+    }
+    return previous[m];
+}
+
+} // namespace
+
+size_t bounded_edit_distance(const std::u32string_view a, const std::u32string_view b, const size_t limit) {
+    std::vector<size_t> table;
+    return bounded_edit_distance(a, b, limit, table);
+}
+
+SimilarWords::SimilarWords(const LessonStore &lessons) {
+    // Distinct words, each represented by the first row that has it.
+    std::unordered_map<std::u32string_view, uint32_t> distinct;
+    distinct.reserve(lessons.size());
+    for (size_t row = 0; row < lessons.size(); ++row) {
+        if (distinct.try_emplace(lessons.folded_word_chars(row), static_cast<uint32_t>(word_rows_.size())).second) {
+            word_rows_.push_back(static_cast<uint32_t>(row));
+        }
+    }
+
+    // Short words are looked up by length; bucket them with a counting sort.
+    size_t max_length = 0;
+    for (const uint32_t row : word_rows_) {
+        max_length = std::max(max_length, lessons.folded_word_chars(row).size());
+    }
+    length_offsets_.assign(max_length + 2, 0);
+    for (const uint32_t row : word_rows_) {
+        ++length_offsets_[lessons.folded_word_chars(row).size() + 1];
+    }
+    for (size_t length = 1; length < length_offsets_.size(); ++length) {
+        length_offsets_[length] += length_offsets_[length - 1];
+    }
+    words_by_length_.resize(word_rows_.size());
+    std::vector<uint32_t> next(length_offsets_.begin(), length_offsets_.end() - 1);
+    for (uint32_t word = 0; word < word_rows_.size(); ++word) {
+        words_by_length_[next[lessons.folded_word_chars(word_rows_[word]).size()]++] = word;
+    }
+
+    // Number the bigrams while collecting every word's tokens, then lay the
+    // postings out with a counting sort so each token's words are contiguous.
+    std::vector<uint32_t> tokens;
+    std::vector<uint32_t> token_offsets{0};
+    token_offsets.reserve(word_rows_.size() + 1);
+    for (const uint32_t row : word_rows_) {
+        for_each_bigram(lessons.folded_word_chars(row), [&](const uint64_t key, const uint32_t occurrence) {
+            const auto [it, inserted] = bigram_ids_.try_emplace(key, static_cast<uint32_t>(bigram_ids_.size()));
+            tokens.push_back(it->second * max_occurrences + occurrence);
+        });
+        token_offsets.push_back(static_cast<uint32_t>(tokens.size()));
+    }
+
+    posting_offsets_.assign(bigram_ids_.size() * max_occurrences + 1, 0);
+    for (const uint32_t token : tokens) {
+        ++posting_offsets_[token + 1];
+    }
+    for (size_t t = 1; t < posting_offsets_.size(); ++t) {
+        posting_offsets_[t] += posting_offsets_[t - 1];
+    }
+    postings_.resize(tokens.size());
+    std::vector<uint32_t> fill(posting_offsets_.begin(), posting_offsets_.end() - 1);
+    for (uint32_t word = 0; word < word_rows_.size(); ++word) {
+        for (uint32_t i = token_offsets[word]; i < token_offsets[word + 1]; ++i) {
+            postings_[fill[tokens[i]]++] = word;
+        }
+    }
+}
+
+void SimilarWords::tokens_of(const std::u32string_view word, std::vector<uint32_t> &tokens) const {
+    tokens.clear();
+    for_each_bigram(word, [&](const uint64_t key, const uint32_t occurrence) {
+        if (const auto it = bigram_ids_.find(key); it != bigram_ids_.end()) {
+            tokens.push_back(it->second * max_occurrences + occurrence);
+        }
+    });
+    // Occurrences past the cap share a token.
+    std::ranges::sort(tokens);
+    tokens.erase(std::ranges::unique(tokens).begin(), tokens.end());
+}
+
+size_t SimilarWords::find(const LessonStore &lessons, const size_t row, const std::span<uint32_t> out,
+                          Rng &rng, const size_t max_distance) const {
+    if (empty() || out.empty()) {
+        return 0;
+    }
+    const std::u32string_view word = lessons.folded_word_chars(row);
+
+    size_t found = 0;
+    size_t checked = 0;
+    std::vector<size_t> table;
+    const auto check = [&](const std::span<const uint32_t> words) {
+        if (words.empty()) {
+            return;
+        }
+        // Start at a random word so that common words do not always get the
+        // same distractors.
+        const size_t start = std::uniform_int_distribution<size_t>{0, words.size() - 1}(rng);
+        for (size_t i = 0; i < words.size(); ++i) {
+            if (found == out.size() || checked == candidate_budget) {
+                break;
+            }
+            const uint32_t candidate = word_rows_[words[(start + i) % words.size()]];
+            if (const auto chosen = out.first(found); std::ranges::find(chosen, candidate) != chosen.end()) {
+                continue;
+            }
+            ++checked;
+            const size_t distance =
+                bounded_edit_distance(word, lessons.folded_word_chars(candidate), max_distance, table);
+            if (distance >= 1 && distance <= max_distance) {
+                out[found++] = candidate;
+            }
+        }
+    };
+
+    // Scan the rarest 3k + 1 tokens, or, for a word with fewer, every word
+    // of a length it could be edited to.
+    std::vector<uint32_t> tokens;
+    tokens_of(word, tokens);
+    const size_t scanned = 3 * max_distance + 1;
+    if (tokens.size() >= scanned) {
+        const auto postings_of = [&](const uint32_t token) {
+            return std::span{postings_}.subspan(posting_offsets_[token],
+                                                posting_offsets_[token + 1] - posting_offsets_[token]);
+        };
+        std::ranges::partial_sort(tokens, tokens.begin() + static_cast<std::ptrdiff_t>(scanned), {},
+                                  [&](const uint32_t token) { return postings_of(token).size(); });
+        for (size_t i = 0; i < scanned; ++i) {
+            check(postings_of(tokens[i]));
+        }
+    } else {
+        const size_t shortest = word.size() > max_distance ? word.size() - max_distance : 0;
+        const size_t longest = std::min(word.size() + max_distance, length_offsets_.size() - 2);
+        for (size_t length = shortest; length <= longest; ++length) {
+            check(std::span{words_by_length_}.subspan(length_offsets_[length],
+                                                      length_offsets_[length + 1] - length_offsets_[length]));
+        }
+    }
+    std::ranges::shuffle(out.first(found), rng);
+    return found;
+}
+
+size_t SimilarWords::memory_usage() const {
+    return bigram_ids_.size() * (sizeof(uint64_t) + sizeof(uint32_t) + 2 * sizeof(void *)) +
+           (word_rows_.capacity() + posting_offsets_.capacity() + postings_.capacity() + length_offsets_.capacity() +
+            words_by_length_.capacity()) * sizeof(uint32_t);
+}
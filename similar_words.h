@@ -0,0 +1,65 @@
+#ifndef LEARNMON_SIMILAR_WORDS_H
+#define LEARNMON_SIMILAR_WORDS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "lesson_store.h"
+#include "rng.h"
+
+// Optimal string alignment distance between `a` and `b` (Levenshtein, with a
+// swap of two adjacent characters counting as one edit) if it is at most
+// `limit`, otherwise limit + 1. Only a band of 2 * limit + 1 diagonals is
+// computed and the scan stops as soon as a whole row exceeds the limit.
+size_t bounded_edit_distance(std::u32string_view a, std::u32string_view b, size_t limit);
+
+// Character-bigram index over the distinct case-folded words of a deck, for
+// finding other deck words a few edits away from a given one. Words are
+// padded with begin and end markers, so every word has bigrams, and a
+// repeated bigram counts as a separate token per occurrence. One edit takes at
+// most three tokens from a word (swapping two adjacent characters replaces
+// three bigrams), so a word within k edits shares at least one of any 3k + 1
+// distinct tokens of the query: a lookup only scans the postings of the
+// query's rarest tokens. Words too short to have 3k + 1 tokens could share
+// none, so they are looked up among all words whose length is within k of
+// theirs instead. The index keeps row numbers only and is queried with the
+// store it was built from.
+class SimilarWords {
+public:
+    static constexpr size_t default_max_distance = 2;
+
+    SimilarWords() = default;
+    explicit SimilarWords(const LessonStore &lessons);
+
+    [[nodiscard]] bool empty() const { return word_rows_.empty(); }
+
+    // Fills `out` with rows of distinct deck words between 1 and
+    // `max_distance` edits from the word of `row`, in random order, and
+    // returns how many were found. The number of candidates checked is
+    // bounded, so a lookup takes the same time on any deck size.
+    size_t find(const LessonStore &lessons, size_t row, std::span<uint32_t> out, Rng &rng,
+                size_t max_distance = default_max_distance) const;
+
+    // Bytes used by the index.
+    [[nodiscard]] size_t memory_usage() const;
+
+private:
+    // Distinct token ids of `word`'s bigram occurrences that are in the index.
+    void tokens_of(std::u32string_view word, std::vector<uint32_t> &tokens) const;
+
+    std::unordered_map<uint64_t, uint32_t> bigram_ids_;
+    // A row for each distinct word; words are numbered by position here.
+    std::vector<uint32_t> word_rows_;
+    // Words containing token t are postings_[posting_offsets_[t], posting_offsets_[t + 1]).
+    std::vector<uint32_t> posting_offsets_;
+    std::vector<uint32_t> postings_;
+    // Words of length l are words_by_length_[length_offsets_[l], length_offsets_[l + 1]).
+    std::vector<uint32_t> length_offsets_;
+    std::vector<uint32_t> words_by_length_;
+};
+
+#endif //LEARNMON_SIMILAR_WORDS_H
@@ -0,0 +1,84 @@
+#include "terminal.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define NOMINMAX
+#include <io.h>
+#include <windows.h>
+#else
+#include <cerrno>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+Terminal Terminal::for_stdout() {
+    if (const char *term = std::getenv("TERM"); term != nullptr && std::string_view{term} == "dumb") {
+        return Terminal{false};
+    }
+#if defined(_WIN32) || defined(_WIN64)
+    if (_isatty(_fileno(stdout)) == 0) {
+        return Terminal{false};
+    }
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    return Terminal{GetConsoleMode(console, &mode) &&
+                    SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING)};
+#else
+    return Terminal{isatty(STDOUT_FILENO) != 0};
+#endif
+}
+
+size_t Terminal::height() const {
+    if (!ansi_) {
+        return 0;
+    }
+#if defined(_WIN32) || defined(_WIN64)
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        return 0;
+    }
+    return static_cast<size_t>(info.srWindow.Bottom - info.srWindow.Top + 1);
+#else
+    winsize size{};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0) {
+        return 0;
+    }
+    return size.ws_row;
+#endif
+}
+
+Screen Screen::for_stdout() {
+#if defined(_WIN32) || defined(_WIN64)
+    return Screen{Terminal::for_stdout(), _fileno(stdout)};
+#else
+    return Screen{Terminal::for_stdout(), STDOUT_FILENO};
+#endif
+}
+
+bool Screen::flush() {
+    std::string_view pending = buffer_;
+    bool ok = true;
+    while (!pending.empty()) {
+#if defined(_WIN32) || defined(_WIN64)
+        const int written = _write(fd_, pending.data(), static_cast<unsigned>(pending.size()));
+        if (written < 0) {
+            ok = false;
+            break;
+        }
+#else
+        const ssize_t written = write(fd_, pending.data(), pending.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ok = false;
+            break;
+        }
+#endif
+        pending.remove_prefix(static_cast<size_t>(written));
+    }
+    buffer_.clear();
+    return ok;
+}
@@ -0,0 +1,108 @@
+#ifndef LEARNMON_TERMINAL_H
+#define LEARNMON_TERMINAL_H
+
+#include <cstddef>
+#include <format>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// In-process screen control for the terminal frontend, instead of running
+// `clear` through system(). When the output is not a terminal (a pipe, a
+// file) or TERM is "dumb" no escape sequence is ever written, so redirected
+// output stays free of escape codes.
+class Terminal {
+public:
+    // Cursor home, erase the screen, erase the scrollback: what `clear` writes.
+    static constexpr std::string_view clear_sequence = "\x1b[H\x1b[2J\x1b[3J";
+
+    // Checks once whether stdout is a terminal that understands ANSI escape
+    // sequences; on Windows this also turns on the console's VT processing.
+    static Terminal for_stdout();
+
+    explicit Terminal(const bool ansi) : ansi_(ansi) {}
+
+    [[nodiscard]] bool ansi() const { return ansi_; }
+
+    // Rows of the terminal window on stdout, asked anew on every call since
+    // windows are resized; 0 if unknown or not a terminal.
+    [[nodiscard]] size_t height() const;
+
+private:
+    bool ansi_;
+};
+
+// Output of the terminal frontend. Text is formatted into one buffer that is
+// reused from screen to screen, and flush() hands a whole screen to the
+// kernel with a single write(2) rather than a write per line. Do not mix with
+// stdio on the same descriptor: it bypasses stdio's buffer.
+class Screen {
+public:
+    // Past this many buffered bytes, long output such as a recap piped to a
+    // file is written out as it goes.
+    static constexpr size_t flush_threshold = 64 * 1024;
+
+    Screen(const Terminal terminal, const int fd) : terminal_(terminal), fd_(fd) {}
+
+    // A screen on stdout.
+    static Screen for_stdout();
+
+    [[nodiscard]] const Terminal &terminal() const { return terminal_; }
+    [[nodiscard]] size_t size() const { return buffer_.size(); }
+
+    // Clears the terminal before what is printed next.
+    void clear() {
+        if (terminal_.ansi()) {
+            buffer_ += Terminal::clear_sequence;
+        }
+    }
+
+    template<typename... Args>
+    void print(const std::format_string<Args...> format, Args &&...args) {
+        std::format_to(std::back_inserter(buffer_), format, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void println(const std::format_string<Args...> format, Args &&...args) {
+        print(format, std::forward<Args>(args)...);
+        buffer_ += '\n';
+    }
+
+    // Writes out and empties the buffer, keeping its capacity: one write,
+    // more only if the kernel takes part of it. False if writing failed.
+    bool flush();
+
+private:
+    Terminal terminal_;
+    int fd_;
+    std::string buffer_;
+};
+
+// Prints `count` lines, where print_line(screen, i) prints line i, a page at
+// a time when the output is a terminal with fewer rows: after each page the
+// reader presses Enter for the next one or types "q" to skip the rest.
+// Returns false if the rest was skipped or `in` ran out.
+template<typename F>
+bool page(Screen &screen, std::istream &in, const size_t count, F &&print_line) {
+    const size_t height = screen.terminal().height();
+    const size_t page_size = height > 1 ? height - 1 : count; // the prompt takes a row
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0 && i % page_size == 0) {
+            screen.print("-- {} of {} lines: Enter for more, q to skip --", i, count);
+            screen.flush();
+            std::string answer;
+            if (!std::getline(in, answer) || answer == "q") {
+                return false;
+            }
+        }
+        print_line(screen, i);
+        if (screen.size() >= Screen::flush_threshold) {
+            screen.flush();
+        }
+    }
+    return true;
+}
+
+#endif //LEARNMON_TERMINAL_H
@@ -0,0 +1,36 @@
+#ifndef LEARNMON_CHECK_H
+#define LEARNMON_CHECK_H
+
+#include <cstdlib>
+#include <iostream>
+#include <print>
+#include <string_view>
+
+// Minimal assertions for the test executables. A failed check prints its
+// location and expression (the first few only, as checks often run in loops
+// over generated cases) and makes check_result() fail the test.
+
+inline int check_failures = 0;
+inline constexpr int max_reported_failures = 20;
+
+inline void check(const bool passed, const std::string_view expression, const std::string_view file, const int line) {
+    if (passed) {
+        return;
+    }
+    if (++check_failures <= max_reported_failures) {
+        std::println(std::cerr, "{}:{}: check failed: {}", file, line, expression);
+    }
+}
+
+#define CHECK(condition) check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+// The exit code of a test's main.
+inline int check_result() {
+    if (check_failures == 0) {
+        return EXIT_SUCCESS;
+    }
+    std::println(std::cerr, "{} check(s) failed.", check_failures);
+    return EXIT_FAILURE;
+}
+
+#endif //LEARNMON_CHECK_H
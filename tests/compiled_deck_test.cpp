@@ -0,0 +1,183 @@
+// Compiles a generated deck to .lmb and maps it back: every row must match the
+// CSV load, stably sorted by lesson number, whole and one lesson at a time,
+// with the same distractor pool in both. Compiling is deterministic, a
+// truncated file is refused and a file with garbage row offsets still reads
+// without leaving the mapping.
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "compiled_deck.h"
+#include "deck.h"
+#include "rng.h"
+#include "utf8.h"
+
+namespace {
+
+constexpr size_t deck_rows = 5'000;
+// Every uint8_t is a lesson number.
+constexpr size_t lesson_numbers = 256;
+
+void write_deck(const std::filesystem::path &path) {
+    constexpr std::string_view words[] = {"сайн", "Байна", "уу", "өглөөний", "МЭНД", "баярлалаа", "x", ""};
+    std::ofstream out{path, std::ios::binary};
+    Rng rng{4};
+    for (size_t i = 0; i < deck_rows; ++i) {
+        // Lessons interleaved in file order; 0 and 255 are valid lesson numbers too.
+        const uint64_t lesson = i % 97 == 0 ? (i % 2 == 0 ? 0 : 255) : 1 + rng() % 20;
+        out << lesson << ';' << words[rng() % std::size(words)] << ' ' << i << ";description " << i << ";origin "
+            << words[rng() % std::size(words)] << '\n';
+    }
+}
+
+std::string read_file(const std::filesystem::path &path) {
+    std::ifstream in{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{in}, {}};
+}
+
+bool same_row(const LessonView &x, const LessonView &y) {
+    return x.lesson_number == y.lesson_number && x.word == y.word && x.description == y.description &&
+           x.origin_word == y.origin_word && x.word_chars == y.word_chars &&
+           x.folded_word_chars == y.folded_word_chars;
+}
+
+bool same_pool(const Distractors &a, const Distractors &b) {
+    return a.count == b.count && a.words == b.words;
+}
+
+// The CSV rows of `lesson_no`, or of every lesson, in the order a compiled deck stores them.
+std::vector<LessonView> sorted_rows(const LessonStore &lessons, const std::optional<uint8_t> lesson_no) {
+    std::vector<LessonView> rows;
+    for (size_t lesson = 0; lesson < lesson_numbers; ++lesson) {
+        if (lesson_no.has_value() && lesson != lesson_no.value()) {
+            continue;
+        }
+        for (const LessonView &row : lessons.views()) {
+            if (row.lesson_number == lesson) {
+                rows.push_back(row);
+            }
+        }
+    }
+    return rows;
+}
+
+} // namespace
+
+int main() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::filesystem::path csv_path = dir / "learnmon_compiled_deck_test.csv";
+    const std::filesystem::path lmb_path = dir / "learnmon_compiled_deck_test.lmb";
+    write_deck(csv_path);
+
+    const Deck csv = load_deck(csv_path, std::nullopt);
+    CHECK(csv.lessons.size() == deck_rows);
+    CHECK(write_compiled_deck(csv, lmb_path));
+    CHECK(is_compiled_deck(lmb_path));
+    CHECK(!is_compiled_deck(csv_path));
+
+    const std::optional<Deck> whole = load_compiled_deck(lmb_path, std::nullopt);
+    CHECK(whole.has_value());
+    if (!whole.has_value()) {
+        return check_result();
+    }
+    const std::vector<LessonView> expected = sorted_rows(csv.lessons, std::nullopt);
+    CHECK(whole->lessons.size() == expected.size());
+    for (size_t row = 0; row < expected.size() && row < whole->lessons.size(); ++row) {
+        CHECK(same_row(whole->lessons[row], expected[row]));
+        const Distractors pool = whole->distractors.row(row);
+        CHECK(pool.count == distractor_pool_size);
+        for (const std::string_view word : pool.words) {
+            CHECK(!word.empty() && word != expected[row].word && validate_utf8(word).has_value());
+        }
+    }
+
+    // One lesson at a time: the same rows as the CSV filter, and the same
+    // pools as the whole deck gives for them.
+    size_t first = 0;
+    for (size_t lesson = 0; lesson < lesson_numbers; ++lesson) {
+        const auto lesson_no = static_cast<uint8_t>(lesson);
+        const std::optional<Deck> part = load_compiled_deck(lmb_path, lesson_no);
+        CHECK(part.has_value());
+        if (!part.has_value()) {
+            continue;
+        }
+        const Deck filtered = load_deck(csv_path, lesson_no);
+        CHECK(part->lessons.size() == filtered.lessons.size());
+        for (size_t row = 0; row < part->lessons.size() && row < filtered.lessons.size(); ++row) {
+            CHECK(same_row(part->lessons[row], filtered.lessons[row]));
+            CHECK(same_pool(part->distractors.row(row), whole->distractors.row(first + row)));
+        }
+        first += part->lessons.size();
+    }
+    CHECK(first == deck_rows);
+
+    // Compiling is deterministic, so rebuilt decks can be compared byte for byte.
+    const std::string bytes = read_file(lmb_path);
+    CHECK(write_compiled_deck(csv, lmb_path));
+    CHECK(read_file(lmb_path) == bytes);
+
+    // A truncated file fails the section bounds check on open.
+    {
+        std::ofstream out{lmb_path, std::ios::binary | std::ios::trunc};
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+    }
+    CHECK(!load_compiled_deck(lmb_path, std::nullopt).has_value());
+
+    // Garbage in every row offset opens, since rows are not checked until they
+    // are read, and reading them stays inside the sections. Most of the garbage
+    // lands just past the end of its section, where an unchecked read would go.
+    LmbHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(LmbHeader));
+    std::string corrupt = bytes;
+    Rng rng{5};
+    const auto scramble = [&]<typename T>(const uint64_t offset, const uint64_t count, const uint64_t limit) {
+        for (uint64_t i = 0; i < count; ++i) {
+            const auto value = static_cast<T>(rng() % 8 == 0 ? rng() : rng() % (limit + limit / 4 + 2));
+            std::memcpy(corrupt.data() + offset + i * sizeof(T), &value, sizeof(T));
+        }
+    };
+    scramble.operator()<uint64_t>(header.offsets_offset, 3 * deck_rows, header.pool_size);
+    scramble.operator()<uint32_t>(header.sizes_offset, 3 * deck_rows, header.pool_size / 8);
+    scramble.operator()<uint64_t>(header.word_char_offsets_offset, deck_rows + 1, header.word_char_count);
+    scramble.operator()<uint64_t>(header.distractor_offsets_offset, deck_rows * distractor_pool_size + 1,
+                                  header.distractor_text_size);
+    {
+        std::ofstream out{lmb_path, std::ios::binary | std::ios::trunc};
+        out.write(corrupt.data(), static_cast<std::streamsize>(corrupt.size()));
+    }
+    const std::optional<Deck> garbled = load_compiled_deck(lmb_path, std::nullopt);
+    CHECK(garbled.has_value());
+    if (garbled.has_value()) {
+        const std::string_view file = garbled->source->view();
+        const std::string_view pool = file.substr(header.pool_offset, header.pool_size);
+        const std::string_view text = file.substr(header.distractor_text_offset, header.distractor_text_size);
+        const auto inside = [](const std::string_view part, const std::string_view section) {
+            return part.empty() || (part.data() >= section.data() &&
+                                    part.data() + part.size() <= section.data() + section.size());
+        };
+        size_t nonempty = 0;
+        for (size_t row = 0; row < garbled->lessons.size(); ++row) {
+            const LessonView view = garbled->lessons[row];
+            CHECK(inside(view.word, pool) && inside(view.description, pool) && inside(view.origin_word, pool));
+            CHECK(view.word_chars.size() <= header.word_char_count);
+            CHECK(view.folded_word_chars.size() == view.word_chars.size());
+            for (const std::string_view word : garbled->distractors.row(row).words) {
+                CHECK(inside(word, text));
+            }
+            nonempty += !view.word.empty();
+        }
+        // The offsets that happened to stay in range still give text.
+        CHECK(nonempty > deck_rows / 2);
+    }
+
+    std::filesystem::remove(csv_path);
+    std::filesystem::remove(lmb_path);
+    return check_result();
+}
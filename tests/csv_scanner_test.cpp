@@ -0,0 +1,80 @@
+// Checks every delimiter-scanning kernel the CPU supports against a plain
+// byte loop, on blocks whose lengths and delimiter positions fall on and
+// around the 16- and 64-byte steps of the SIMD loops and in their scalar tails.
+
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "csv_scanner.h"
+#include "rng.h"
+
+namespace {
+
+std::vector<uint32_t> reference_offsets(const std::string_view block) {
+    std::vector<uint32_t> offsets;
+    for (uint32_t i = 0; i < block.size(); ++i) {
+        if (block[i] == ';' || block[i] == '\n') {
+            offsets.push_back(i);
+        }
+    }
+    return offsets;
+}
+
+void check_kernel(const ScanKernel kernel, const std::string_view block) {
+    std::vector<uint32_t> offsets(block.size());
+    offsets.resize(scan_delimiters(block, offsets, kernel));
+    CHECK(offsets == reference_offsets(block));
+}
+
+std::vector<ScanKernel> supported_kernels() {
+    std::vector<ScanKernel> kernels = {ScanKernel::Scalar};
+    const ScanKernel best = detect_scan_kernel();
+    if (best != ScanKernel::Scalar) {
+        kernels.push_back(ScanKernel::Sse2);
+    }
+    if (best == ScanKernel::Avx2) {
+        kernels.push_back(ScanKernel::Avx2);
+    }
+    return kernels;
+}
+
+} // namespace
+
+int main() {
+    const std::vector<ScanKernel> kernels = supported_kernels();
+    Rng rng{1};
+
+    // A single delimiter at every position of blocks up to three 64-byte steps long.
+    for (size_t size = 0; size <= 3 * 64 + 1; ++size) {
+        for (size_t at = 0; at < size; ++at) {
+            for (const char delimiter : {';', '\n'}) {
+                std::string block(size, 'x');
+                block[at] = delimiter;
+                for (const ScanKernel kernel : kernels) {
+                    check_kernel(kernel, block);
+                }
+            }
+        }
+    }
+
+    // Random blocks with dense delimiters and bytes above 0x7f, which a
+    // signed comparison would get wrong.
+    constexpr std::string_view alphabet = ";\n;\na\xd0\x80\xff";
+    for (int round = 0; round < 2000; ++round) {
+        std::string block(rng() % 300, ' ');
+        for (char &c : block) {
+            c = alphabet[rng() % alphabet.size()];
+        }
+        for (const ScanKernel kernel : kernels) {
+            check_kernel(kernel, block);
+        }
+    }
+
+    // The whole block full of delimiters, so the output fills its span.
+    const std::string full(1000, ';');
+    for (const ScanKernel kernel : kernels) {
+        check_kernel(kernel, full);
+    }
+    return check_result();
+}
@@ -0,0 +1,101 @@
+// Compares FuzzyMatcher with the full Levenshtein table on random words and
+// answers a few random edits away: Myers' bit-parallel path up to 64
+// codepoints, the banded fallback beyond, words with characters that share a
+// mask slot, and every limit from exact to larger than any distance.
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "check.h"
+#include "fuzzy_match.h"
+#include "rng.h"
+
+namespace {
+
+size_t edit_distance(const std::u32string_view a, const std::u32string_view b) {
+    std::vector<size_t> previous(b.size() + 1);
+    std::vector<size_t> current(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) {
+        previous[j] = j;
+    }
+    for (size_t i = 1; i <= a.size(); ++i) {
+        current[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            current[j] = std::min({previous[j - 1] + (a[i - 1] != b[j - 1] ? 1 : 0), previous[j] + 1,
+                                   current[j - 1] + 1});
+        }
+        std::swap(previous, current);
+    }
+    return previous[b.size()];
+}
+
+// 'а' (U+0430), 'Ѱ' (U+0470) and '0' (U+0030) all fall in mask slot 48, and
+// 'б' and '1' in slot 49, so most words need the overflow list.
+constexpr std::u32string_view letters = U"аѰ0б1вөү";
+
+std::u32string random_word(Rng &rng, const size_t length) {
+    std::u32string word(length, U' ');
+    for (char32_t &c : word) {
+        c = letters[rng() % letters.size()];
+    }
+    return word;
+}
+
+// `word` with up to `edits` random substitutions, insertions and deletions.
+std::u32string edited(std::u32string word, Rng &rng, const size_t edits) {
+    for (size_t k = rng() % (edits + 1); k > 0; --k) {
+        const size_t at = word.empty() ? 0 : rng() % word.size();
+        switch (rng() % 3) {
+            case 0:
+                if (!word.empty()) {
+                    word[at] = letters[rng() % letters.size()];
+                }
+                break;
+            case 1: word.insert(word.begin() + static_cast<std::ptrdiff_t>(at), letters[rng() % letters.size()]); break;
+            default:
+                if (!word.empty()) {
+                    word.erase(at, 1);
+                }
+        }
+    }
+    return word;
+}
+
+} // namespace
+
+int main() {
+    Rng rng{19};
+    for (size_t round = 0; round < 20'000; ++round) {
+        // Lengths around both sides of the 64-codepoint machine word.
+        const size_t length = round % 4 == 0 ? 60 + rng() % 10 : rng() % 20;
+        const std::u32string word = random_word(rng, length);
+        const FuzzyMatcher matcher{word};
+        const std::u32string answer = round % 8 == 0 ? random_word(rng, rng() % 20) : edited(word, rng, 6);
+        const size_t expected = edit_distance(answer, word);
+
+        for (const size_t limit : {size_t{0}, size_t{1}, size_t{2}, size_t{3}, size_t{5}, size_t{8}, size_t{100}}) {
+            CHECK(matcher.distance(answer, limit) == std::min(expected, limit + 1));
+        }
+
+        // One mistake per edit, at answer positions in order.
+        const std::vector<AnswerMistake> mistakes = matcher.mistakes(answer);
+        CHECK(mistakes.size() == expected);
+        CHECK(std::ranges::is_sorted(mistakes, {}, &AnswerMistake::position));
+        CHECK(std::ranges::all_of(mistakes, [&](const AnswerMistake &mistake) {
+            return mistake.position < answer.size() ||
+                   (mistake.kind == MistakeKind::Missing && mistake.position == answer.size());
+        }));
+    }
+
+    // Exactly 64 codepoints uses every bit of the masks.
+    const std::u32string full = random_word(rng, FuzzyMatcher::max_bit_parallel_length);
+    const FuzzyMatcher matcher{full};
+    CHECK(matcher.distance(full, 0) == 0);
+    CHECK(matcher.distance(full.substr(1), 2) == 1);
+    CHECK(matcher.distance(full + U'а', 2) == 1);
+    CHECK(matcher.distance(U"", 100) == full.size());
+    return check_result();
+}
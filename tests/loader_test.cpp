@@ -0,0 +1,135 @@
+// Loads a generated deck, with every kind of bad line mixed in, on one thread
+// and on several: the rows and the load report must not depend on how the
+// file was cut into chunks. read_deck, the copying loader, must agree too.
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "deck.h"
+#include "lesson_index.h"
+#include "rng.h"
+
+namespace {
+
+// Over 16 MiB, so that the loader cuts it into several chunks of at least 4 MiB.
+constexpr size_t deck_rows = 500'000;
+// Half of them bad, one every other line: far more index ranges than any
+// machine has threads.
+constexpr size_t dirty_rows = 300'000;
+
+void write_deck(const std::filesystem::path &path) {
+    std::ofstream out{path, std::ios::binary};
+    Rng rng{3};
+    for (size_t i = 0; i < deck_rows; ++i) {
+        const size_t lesson = i * 255 / deck_rows + 1;
+        switch (rng() % 200) {
+            case 0: out << "abc;word;description;origin\n"; break;
+            case 1: out << lesson << ";only two\n"; break;
+            case 2: out << lesson << ";\xff\xfe;description;origin\n"; break;
+            case 3: out << "300;word;description;origin\n"; break;
+            case 4: out << "\n"; break;
+            default:
+                out << lesson << ";Сайн байна уу " << i << ";Sain baina uu;Hello " << i << ";extra\n";
+        }
+    }
+    out << "7;last line;without;newline";
+}
+
+bool same_rows(const LessonStore &a, const LessonStore &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t row = 0; row < a.size(); ++row) {
+        const LessonView x = a[row];
+        const LessonView y = b[row];
+        if (x.lesson_number != y.lesson_number || x.word != y.word || x.description != y.description ||
+            x.origin_word != y.origin_word || x.word_chars != y.word_chars ||
+            x.folded_word_chars != y.folded_word_chars) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool same_report(const LoadReport &a, const LoadReport &b) {
+    if (a.lines != b.lines || a.skipped != b.skipped || a.issues.size() != b.issues.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.issues.size(); ++i) {
+        if (a.issues[i].line != b.issues[i].line || a.issues[i].column != b.issues[i].column ||
+            a.issues[i].reason != b.issues[i].reason) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "learnmon_loader_test.csv";
+    write_deck(path);
+
+    const Deck single = load_deck(path, std::nullopt, 1);
+    CHECK(single.lessons.size() > deck_rows * 9 / 10);
+    CHECK(single.report.lines == deck_rows + 1);
+    CHECK(single.report.skipped_lines() > 0);
+    for (const unsigned threads : {2u, 3u, 7u, 64u}) {
+        const Deck parallel = load_deck(path, std::nullopt, threads);
+        CHECK(same_rows(single.lessons, parallel.lessons));
+        CHECK(same_report(single.report, parallel.report));
+    }
+    const Deck copied = read_deck(path, std::nullopt, 4);
+    CHECK(same_rows(single.lessons, copied.lessons));
+    CHECK(same_report(single.report, copied.report));
+
+    // A filtered load gives the same report as the full one, both while it
+    // builds the sidecar index and when it later loads through it.
+    for (const uint8_t lesson : {uint8_t{1}, uint8_t{7}, uint8_t{128}, uint8_t{255}}) {
+        std::filesystem::remove(lesson_index_path(path));
+        const Deck cold = load_deck(path, lesson, 4);
+        const Deck indexed = load_deck(path, lesson, 4);
+        const Deck reference = read_deck(path, lesson, 1);
+        CHECK(std::filesystem::exists(lesson_index_path(path)));
+        CHECK(same_rows(reference.lessons, cold.lessons));
+        CHECK(same_rows(reference.lessons, indexed.lessons));
+        CHECK(same_report(single.report, cold.report));
+        CHECK(same_report(single.report, indexed.report));
+    }
+
+    // Every other line of a dirty deck is bad, so its index holds a range per
+    // bad line, interleaved with the lesson's own lines. A load through it
+    // must still be one parse, not a thread or a result per range.
+    const std::filesystem::path dirty_path =
+            std::filesystem::temp_directory_path() / "learnmon_loader_test_dirty.csv";
+    {
+        std::ofstream out{dirty_path, std::ios::binary};
+        for (size_t i = 0; i < dirty_rows; ++i) {
+            if (i % 2 == 0) {
+                out << "x" << i << ";bad;line;here\n";
+            } else {
+                out << 1 + i % 3 << ";word " << i << ";description;origin\n";
+            }
+        }
+    }
+    const Deck dirty = load_deck(dirty_path, std::nullopt, 1);
+    CHECK(dirty.report.skipped_lines() == dirty_rows / 2);
+    std::filesystem::remove(lesson_index_path(dirty_path));
+    const Deck dirty_cold = load_deck(dirty_path, uint8_t{2}, 4);
+    const Deck dirty_indexed = load_deck(dirty_path, uint8_t{2}, 4);
+    const Deck dirty_reference = read_deck(dirty_path, uint8_t{2}, 1);
+    CHECK(dirty_reference.lessons.size() == dirty_rows / 6);
+    CHECK(same_rows(dirty_reference.lessons, dirty_cold.lessons));
+    CHECK(same_rows(dirty_reference.lessons, dirty_indexed.lessons));
+    CHECK(same_report(dirty.report, dirty_indexed.report));
+
+    std::filesystem::remove(lesson_index_path(dirty_path));
+    std::filesystem::remove(dirty_path);
+    std::filesystem::remove(lesson_index_path(path));
+    std::filesystem::remove(path);
+    return check_result();
+}
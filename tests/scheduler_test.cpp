@@ -0,0 +1,143 @@
+// Checks the SM-2 updates of Scheduler against hand-computed sequences, the
+// order take_due hands out cards in, and that replaying a log leaves the same
+// states and queues as reviewing the same records one by one.
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <vector>
+
+#include "check.h"
+#include "scheduler.h"
+
+namespace {
+
+constexpr int64_t day = 24 * 60 * 60;
+constexpr int64_t start = 1'700'000'000;
+constexpr uint32_t user = 7;
+
+// Reviews one card with each grade in turn, a day after it fell due, and
+// checks the interval and ease factor after every review.
+struct Step {
+    uint8_t grade;
+    uint32_t interval_days;
+    uint16_t ease_permille;
+};
+
+void check_sequence(const std::initializer_list<Step> steps) {
+    Scheduler scheduler;
+    constexpr uint64_t card = 1;
+    scheduler.add(user, card, start);
+    int64_t now = start;
+    for (const Step &step : steps) {
+        scheduler.review({now, card, user, step.grade});
+        const CardState *state = scheduler.state(user, card);
+        CHECK(state != nullptr);
+        if (state == nullptr) {
+            return;
+        }
+        CHECK(state->interval_days == step.interval_days);
+        CHECK(state->ease_permille == step.ease_permille);
+        const int64_t delay = step.interval_days == 0 ? Scheduler::relearn_delay_seconds : step.interval_days * day;
+        CHECK(state->due == now + delay);
+        CHECK(scheduler.next_due(user) == state->due);
+        now = state->due + day;
+    }
+}
+
+} // namespace
+
+int main() {
+    // Quality 4 keeps the ease at 2.5: 1 day, 6 days, then times 2.5, rounded.
+    check_sequence({{4, 1, 2500}, {4, 6, 2500}, {4, 15, 2500}, {4, 38, 2500}, {4, 95, 2500}});
+    // Quality 5 adds 0.1 after each review; the interval uses the ease from before it.
+    check_sequence({{5, 1, 2600}, {5, 6, 2700}, {5, 16, 2800}, {5, 45, 2900}});
+    // Quality 3 passes but takes 0.14 off.
+    check_sequence({{3, 1, 2360}, {3, 6, 2220}, {3, 13, 2080}});
+    // A failure starts the card over ten minutes later and takes 0.54 off,
+    // down to the 1.3 floor; the next pass is one day again.
+    check_sequence({{4, 1, 2500}, {4, 6, 2500}, {grade_failed, 0, 1960}, {grade_failed, 0, 1420},
+                    {grade_failed, 0, 1300}, {grade_solved, 1, 1300}, {grade_solved, 6, 1300},
+                    {grade_solved, 8, 1300}});
+    // Grades above 5 count as 5.
+    check_sequence({{9, 1, 2600}});
+
+    // Cards due at the same time come out in the order they were added, and
+    // none before it is due.
+    {
+        Scheduler scheduler;
+        for (const uint64_t card : {30, 10, 20}) {
+            scheduler.add(user, card, start);
+        }
+        scheduler.add(user, 40, start + 5);
+        scheduler.add(user, 10, start - 100); // already added: stays where it is
+        CHECK(!scheduler.take_due(user, start - 1).has_value());
+        CHECK(!scheduler.take_due(user + 1, start).has_value());
+        CHECK(scheduler.take_due(user, start) == 30);
+        CHECK(scheduler.take_due(user, start) == 10);
+        CHECK(scheduler.take_due(user, start) == 20);
+        CHECK(!scheduler.take_due(user, start).has_value());
+        CHECK(scheduler.next_due(user) == start + 5);
+        CHECK(scheduler.take_due(user, start + 5) == 40);
+        CHECK(!scheduler.next_due(user).has_value());
+
+        // Reviewed cards come back by their new due time. Reviewing a card
+        // again leaves a stale entry that must not hand it out twice.
+        scheduler.review({start, 30, user, grade_solved});
+        scheduler.review({start, 10, user, grade_failed});
+        scheduler.review({start, 20, user, grade_failed});
+        scheduler.review({start + 1, 20, user, grade_solved});
+        scheduler.review({start, 99, user, grade_solved}); // never added: ignored
+        CHECK(scheduler.state(user, 99) == nullptr);
+        CHECK(scheduler.take_due(user, start + day) == 10);
+        CHECK(scheduler.take_due(user, start + 2 * day) == 30);
+        CHECK(scheduler.take_due(user, start + 2 * day) == 20);
+        CHECK(!scheduler.take_due(user, start + 100 * day).has_value());
+    }
+
+    // Replaying a log gives the states of reviewing it record by record, and
+    // queues that hand the cards out by the same due times. (Cards due at the
+    // same time may come out in another order: replay keeps the order they
+    // were added in.)
+    {
+        std::vector<ReviewRecord> log;
+        for (uint64_t i = 0; i < 200; ++i) {
+            const uint64_t card = i * 7 % 23;
+            log.push_back({start + static_cast<int64_t>(i) * 3600, card, static_cast<uint32_t>(i % 2),
+                           static_cast<uint8_t>(i * 5 % 6)});
+        }
+        Scheduler reviewed;
+        Scheduler replayed;
+        for (const uint32_t u : {0u, 1u}) {
+            for (uint64_t card = 0; card < 23; ++card) {
+                reviewed.add(u, card, start);
+                replayed.add(u, card, start);
+            }
+        }
+        for (const ReviewRecord &record : log) {
+            reviewed.review(record);
+        }
+        replayed.replay(log);
+        for (const uint32_t u : {0u, 1u}) {
+            for (uint64_t card = 0; card < 23; ++card) {
+                const CardState *a = reviewed.state(u, card);
+                const CardState *b = replayed.state(u, card);
+                CHECK(a != nullptr && b != nullptr && a->due == b->due && a->interval_days == b->interval_days &&
+                      a->repetitions == b->repetitions && a->ease_permille == b->ease_permille);
+            }
+            const auto due_order = [&](Scheduler &scheduler) {
+                std::vector<int64_t> dues;
+                while (const std::optional<uint64_t> card = scheduler.take_due(u, start + 1000 * day)) {
+                    dues.push_back(scheduler.state(u, card.value())->due);
+                }
+                return dues;
+            };
+            const std::vector<int64_t> dues = due_order(reviewed);
+            CHECK(dues.size() == 23);
+            CHECK(std::ranges::is_sorted(dues));
+            CHECK(due_order(replayed) == dues);
+        }
+    }
+    return check_result();
+}
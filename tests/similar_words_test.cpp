@@ -0,0 +1,115 @@
+// Looks up every word of a small random deck in SimilarWords and compares the
+// answer with a scan of the whole deck: the index may only skip work, never
+// words. The deck is small enough that no lookup runs out of its candidate
+// budget, and its words are short and drawn from a few letters, so there are
+// many swaps, short words and repeated bigrams.
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "check.h"
+#include "deck.h"
+#include "rng.h"
+#include "similar_words.h"
+#include "utf8.h"
+
+namespace {
+
+// Optimal string alignment distance over the whole table, as the reference
+// for bounded_edit_distance.
+size_t edit_distance(const std::u32string_view a, const std::u32string_view b) {
+    std::vector table(a.size() + 1, std::vector<size_t>(b.size() + 1));
+    for (size_t i = 0; i <= a.size(); ++i) {
+        for (size_t j = 0; j <= b.size(); ++j) {
+            if (i == 0 || j == 0) {
+                table[i][j] = i + j;
+                continue;
+            }
+            table[i][j] = std::min({table[i - 1][j - 1] + (a[i - 1] != b[j - 1] ? 1 : 0), table[i - 1][j] + 1,
+                                    table[i][j - 1] + 1});
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                table[i][j] = std::min(table[i][j], table[i - 2][j - 2] + 1);
+            }
+        }
+    }
+    return table[a.size()][b.size()];
+}
+
+void write_deck(const std::filesystem::path &path) {
+    // Upper and lower case, so that words differing only in case are one word.
+    constexpr std::u32string_view letters = U"абвгдеАБөү";
+    std::ofstream out{path, std::ios::binary};
+    for (const std::string_view word : {"аб", "ба", "а", "в", "абв", "бав", "вба", "абаб", "баба", "аааа"}) {
+        out << "1;" << word << ";;\n";
+    }
+    Rng rng{18};
+    for (size_t i = 0; i < 300; ++i) {
+        std::u32string word(1 + rng() % 7, U' ');
+        for (char32_t &c : word) {
+            c = letters[rng() % letters.size()];
+        }
+        out << "1;" << encode_utf8(word) << ";;\n";
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "learnmon_similar_words_test.csv";
+    write_deck(path);
+    const Deck deck = load_deck(path, std::nullopt);
+    std::filesystem::remove(path);
+    const LessonStore &lessons = deck.lessons;
+    const SimilarWords index{lessons};
+
+    // The distinct words, each as the first row that has it, as find returns them.
+    std::vector<uint32_t> word_rows;
+    std::unordered_set<std::u32string_view> seen;
+    for (uint32_t row = 0; row < lessons.size(); ++row) {
+        if (seen.insert(lessons.folded_word_chars(row)).second) {
+            word_rows.push_back(row);
+        }
+    }
+
+    Rng rng{19};
+    std::vector<uint32_t> out(word_rows.size());
+    for (const size_t max_distance : {1u, 2u, 3u}) {
+        for (size_t row = 0; row < lessons.size(); ++row) {
+            const std::u32string_view word = lessons.folded_word_chars(row);
+            std::vector<uint32_t> expected;
+            for (const uint32_t candidate : word_rows) {
+                const size_t distance = edit_distance(word, lessons.folded_word_chars(candidate));
+                CHECK(bounded_edit_distance(word, lessons.folded_word_chars(candidate), max_distance) ==
+                      std::min(distance, max_distance + 1));
+                if (distance >= 1 && distance <= max_distance) {
+                    expected.push_back(candidate);
+                }
+            }
+
+            // Room for every word: all of them must be found.
+            std::vector<uint32_t> found(out.begin(), out.begin() +
+                                        static_cast<std::ptrdiff_t>(index.find(lessons, row, out, rng, max_distance)));
+            std::ranges::sort(found);
+            CHECK(found == expected);
+
+            // Room for fewer: the slots are filled, with distinct words from the scan.
+            if (expected.size() > 1) {
+                const std::span<uint32_t> few = std::span{out}.first(expected.size() / 2);
+                const size_t count = index.find(lessons, row, few, rng, max_distance);
+                CHECK(count == few.size());
+                std::vector<uint32_t> chosen(few.begin(), few.begin() + static_cast<std::ptrdiff_t>(count));
+                std::ranges::sort(chosen);
+                CHECK(std::ranges::adjacent_find(chosen) == chosen.end());
+                CHECK(std::ranges::includes(expected, chosen));
+            }
+        }
+    }
+    return check_result();
+}
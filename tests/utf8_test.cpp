@@ -0,0 +1,104 @@
+// Checks the UTF-8 validator on every kernel the CPU supports: valid random
+// text must pass, and each kind of malformed sequence (truncated, overlong,
+// surrogate, above U+10FFFF, stray continuation) must be reported at the byte
+// it starts on, at every offset across the 32-byte blocks of the AVX2 kernel.
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "check.h"
+#include "rng.h"
+#include "utf8.h"
+
+namespace {
+
+std::vector<ScanKernel> supported_kernels() {
+    std::vector<ScanKernel> kernels = {ScanKernel::Scalar};
+    if (detect_scan_kernel() >= ScanKernel::Avx2) {
+        kernels.push_back(ScanKernel::Avx2);
+    }
+    return kernels;
+}
+
+// Valid text of exactly `size` bytes, mixing sequences of every length.
+std::string valid_text(Rng &rng, const size_t size) {
+    constexpr std::u32string_view samples = U"aZ;\nжӨөÿࠀ퟿￿\U00010000\U0010FFFF";
+    std::string text;
+    while (text.size() < size) {
+        std::string next = encode_utf8(samples.substr(rng() % samples.size(), 1));
+        if (text.size() + next.size() > size) {
+            next = "a";
+        }
+        text += next;
+    }
+    return text;
+}
+
+// Sequences that are invalid from their first byte on.
+constexpr std::string_view malformed[] = {
+    "\x80",             // continuation without a lead
+    "\xBF\x80",
+    "\xC3",             // truncated before ASCII or the end
+    "\xE0\xA0",
+    "\xF0\x90\x80",
+    "\xC3\xC3\xA9",     // a lead where a continuation belongs
+    "\xE2\x82\xE2\x82\xAC",
+    "\xC0\x80",         // overlong
+    "\xC1\xBF",
+    "\xE0\x80\x80",
+    "\xE0\x9F\xBF",
+    "\xF0\x80\x80\x80",
+    "\xF0\x8F\xBF\xBF",
+    "\xED\xA0\x80",     // surrogates
+    "\xED\xBF\xBF",
+    "\xF4\x90\x80\x80", // above U+10FFFF
+    "\xF5\x80\x80\x80",
+    "\xF8\x88\x80\x80\x80",
+    "\xFE",
+    "\xFF",
+};
+
+} // namespace
+
+int main() {
+    const std::vector<ScanKernel> kernels = supported_kernels();
+    Rng rng{10};
+
+    for (size_t size = 0; size < 300; ++size) {
+        const std::string text = valid_text(rng, size);
+        for (const ScanKernel kernel : kernels) {
+            CHECK(validate_utf8(text, kernel).has_value());
+        }
+    }
+
+    // Each malformed sequence at every offset up to a few blocks in, followed
+    // by nothing, by ASCII or by more valid text that may end in any block.
+    for (const std::string_view bad : malformed) {
+        for (size_t offset = 0; offset < 100; ++offset) {
+            for (const size_t after : {size_t{0}, size_t{1}, size_t{31 - offset % 32}, size_t{40 + rng() % 60}}) {
+                const std::string text = valid_text(rng, offset) + std::string{bad} + valid_text(rng, after);
+                for (const ScanKernel kernel : kernels) {
+                    const auto checked = validate_utf8(text, kernel);
+                    CHECK(!checked.has_value() && checked.error() == offset);
+                }
+            }
+        }
+    }
+
+    // Several errors: the first one counts, wherever the blocks fall.
+    for (size_t round = 0; round < 2'000; ++round) {
+        std::string text = valid_text(rng, rng() % 150);
+        const size_t first = text.size();
+        for (size_t k = 1 + rng() % 3; k > 0; --k) {
+            // ASCII after each, so that a truncated one is not completed by the next.
+            text += malformed[rng() % std::size(malformed)];
+            text += ';' + valid_text(rng, rng() % 40);
+        }
+        for (const ScanKernel kernel : kernels) {
+            const auto checked = validate_utf8(text, kernel);
+            CHECK(!checked.has_value() && checked.error() == first);
+        }
+    }
+    return check_result();
+}
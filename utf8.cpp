@@ -0,0 +1,303 @@
+#include "utf8.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LEARNMON_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Length of the sequence started by `lead`, or 0 if it cannot start one.
+size_t sequence_length(const uint8_t lead) {
+    if (lead < 0x80) {
+        return 1;
+    }
+    if ((lead & 0xE0) == 0xC0) {
+        return 2;
+    }
+    if ((lead & 0xF0) == 0xE0) {
+        return 3;
+    }
+    if ((lead & 0xF8) == 0xF0) {
+        return 4;
+    }
+    return 0;
+}
+
+bool is_continuation(const uint8_t byte) {
+    return (byte & 0xC0) == 0x80;
+}
+
+// Validates from `from`, which must be the start of a sequence, following
+// table 3-7 of the Unicode standard.
+std::expected<void, size_t> validate_scalar(const std::string_view s, const size_t from) {
+    const auto *bytes = reinterpret_cast<const uint8_t *>(s.data());
+    size_t i = from;
+    while (i < s.size()) {
+        // Eight ASCII bytes at a time.
+        if (uint64_t word = 0; i + 8 <= s.size() && (std::memcpy(&word, bytes + i, 8), word & 0x8080808080808080) == 0) {
+            i += 8;
+            continue;
+        }
+
+        const uint8_t lead = bytes[i];
+        if (lead < 0x80) {
+            ++i;
+            continue;
+        }
+
+        // Length of the sequence and the range allowed for its second byte.
+        size_t length = 0;
+        uint8_t second_min = 0x80;
+        uint8_t second_max = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            second_min = lead == 0xE0 ? 0xA0 : 0x80;
+            second_max = lead == 0xED ? 0x9F : 0xBF;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            second_min = lead == 0xF0 ? 0x90 : 0x80;
+            second_max = lead == 0xF4 ? 0x8F : 0xBF;
+        } else {
+            return std::unexpected(i);
+        }
+
+        if (s.size() - i < length || bytes[i + 1] < second_min || bytes[i + 1] > second_max) {
+            return std::unexpected(i);
+        }
+        for (size_t k = 2; k < length; ++k) {
+            if (!is_continuation(bytes[i + k])) {
+                return std::unexpected(i);
+            }
+        }
+        i += length;
+    }
+    return {};
+}
+
+#ifdef LEARNMON_X86_SIMD
+
+// The lookup algorithm of Keiser and Lemire, "Validating UTF-8 In Less Than
+// One Instruction Per Byte" (2021). Each byte is classified by the high nibble
+// of its predecessor, the low nibble of its predecessor and its own high
+// nibble; a bit that survives in all three lookups is an error. Sequences of
+// three and four bytes are then checked against the bytes two and three back.
+constexpr uint8_t too_short = 1 << 0;
+constexpr uint8_t too_long = 1 << 1;
+constexpr uint8_t overlong_3 = 1 << 2;
+constexpr uint8_t too_large = 1 << 3;
+constexpr uint8_t surrogate = 1 << 4;
+constexpr uint8_t overlong_2 = 1 << 5;
+constexpr uint8_t too_large_1000 = 1 << 6;
+constexpr uint8_t overlong_4 = 1 << 6;
+constexpr uint8_t two_continuations = 1 << 7;
+constexpr uint8_t carry = too_short | too_long | two_continuations;
+
+constexpr std::array<uint8_t, 16> byte_1_high_table = {
+    too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+    two_continuations, two_continuations, two_continuations, two_continuations,
+    too_short | overlong_2,
+    too_short,
+    too_short | overlong_3 | surrogate,
+    too_short | too_large | too_large_1000 | overlong_4,
+};
+
+constexpr std::array<uint8_t, 16> byte_1_low_table = {
+    carry | overlong_3 | overlong_2 | overlong_4,
+    carry | overlong_2,
+    carry,
+    carry,
+    carry | too_large,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000 | surrogate,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+};
+
+constexpr std::array<uint8_t, 16> byte_2_high_table = {
+    too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+    too_long | overlong_2 | two_continuations | overlong_3 | too_large_1000 | overlong_4,
+    too_long | overlong_2 | two_continuations | overlong_3 | too_large,
+    too_long | overlong_2 | two_continuations | surrogate | too_large,
+    too_long | overlong_2 | two_continuations | surrogate | too_large,
+    too_short, too_short, too_short, too_short,
+};
+
+__attribute__((target("avx2")))
+__m256i broadcast_table(const std::array<uint8_t, 16> &table) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(table.data())));
+}
+
+// The input shifted right by `N` bytes, with the last bytes of `previous` moved in.
+template<int N>
+__attribute__((target("avx2")))
+__m256i previous_bytes(const __m256i input, const __m256i previous) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+}
+
+__attribute__((target("avx2")))
+__m256i high_nibbles(const __m256i bytes) {
+    return _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F));
+}
+
+struct Avx2Utf8State {
+    __m256i previous;
+    __m256i previous_incomplete;
+};
+
+// Returns a non-zero vector if `input`, read after `state.previous`, has an error.
+__attribute__((target("avx2")))
+__m256i check_block(const __m256i input, Avx2Utf8State &state) {
+    __m256i error;
+    if (_mm256_movemask_epi8(input) == 0) {
+        // All ASCII: only a sequence left open by the previous block can fail.
+        error = state.previous_incomplete;
+        state.previous_incomplete = _mm256_setzero_si256();
+    } else {
+        const __m256i prev1 = previous_bytes<1>(input, state.previous);
+        const __m256i byte_1_high = _mm256_shuffle_epi8(broadcast_table(byte_1_high_table), high_nibbles(prev1));
+        const __m256i byte_1_low = _mm256_shuffle_epi8(broadcast_table(byte_1_low_table),
+                                                       _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+        const __m256i byte_2_high = _mm256_shuffle_epi8(broadcast_table(byte_2_high_table), high_nibbles(input));
+        const __m256i special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+        // Third and fourth bytes must be continuations; the lookups above only
+        // see pairs of bytes.
+        const __m256i prev2 = previous_bytes<2>(input, state.previous);
+        const __m256i prev3 = previous_bytes<3>(input, state.previous);
+        const __m256i is_third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+        const __m256i is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+        const __m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte),
+                                                              _mm256_set1_epi8(static_cast<char>(0x80)));
+        error = _mm256_xor_si256(must_be_continuation, special_cases);
+
+        // A lead byte in the last three positions needs bytes from the next block.
+        const __m256i max_complete = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+        state.previous_incomplete = _mm256_subs_epu8(input, max_complete);
+    }
+    state.previous = input;
+    return error;
+}
+
+__attribute__((target("avx2")))
+std::expected<void, size_t> validate_avx2(const std::string_view s) {
+    Avx2Utf8State state{_mm256_setzero_si256(), _mm256_setzero_si256()};
+    size_t i = 0;
+    const auto fail_at = [&](const size_t block) {
+        // The error is in this block or in a sequence started at most three
+        // bytes before it; find its exact offset with the scalar validator.
+        size_t from = block >= 3 ? block - 3 : 0;
+        while (from < block && is_continuation(static_cast<uint8_t>(s[from]))) {
+            ++from;
+        }
+        const auto exact = validate_scalar(s, from);
+        return std::unexpected(exact.has_value() ? block : exact.error());
+    };
+
+    for (; i + 32 <= s.size(); i += 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s.data() + i));
+        if (const __m256i error = check_block(input, state); !_mm256_testz_si256(error, error)) {
+            return fail_at(i);
+        }
+    }
+
+    // The tail is padded with ASCII zeros, which cannot complete a sequence.
+    alignas(32) std::array<char, 32> tail{};
+    if (i < s.size()) {
+        std::memcpy(tail.data(), s.data() + i, s.size() - i);
+    }
+    const __m256i input = _mm256_load_si256(reinterpret_cast<const __m256i *>(tail.data()));
+    __m256i error = check_block(input, state);
+    error = _mm256_or_si256(error, state.previous_incomplete);
+    if (!_mm256_testz_si256(error, error)) {
+        return fail_at(i);
+    }
+    return {};
+}
+
+#endif
+
+} // namespace
+
+std::expected<void, size_t> validate_utf8(const std::string_view s) {
+    return validate_utf8(s, detect_scan_kernel());
+}
+
+std::expected<void, size_t> validate_utf8(const std::string_view s, const ScanKernel kernel) {
+#ifdef LEARNMON_X86_SIMD
+    if (kernel == ScanKernel::Avx2) {
+        return validate_avx2(s);
+    }
+#endif
+    return validate_scalar(s, 0);
+}
+
+size_t decode_utf8(const std::string_view s, char32_t *out) {
+    char32_t *next = out;
+    for (size_t i = 0; i < s.size();) {
+        const auto lead = static_cast<uint8_t>(s[i]);
+        const size_t length = sequence_length(lead);
+        if (length <= 1 || i + length > s.size()) {
+            *next++ = lead;
+            i += 1;
+            continue;
+        }
+
+        char32_t codepoint = lead & (0x7F >> length);
+        for (size_t k = 1; k < length; ++k) {
+            codepoint = (codepoint << 6) | (static_cast<uint8_t>(s[i + k]) & 0x3F);
+        }
+        *next++ = codepoint;
+        i += length;
+    }
+    return static_cast<size_t>(next - out);
+}
+
+std::u32string decode_utf8(const std::string_view s) {
+    std::u32string chars(s.size(), U'\0');
+    chars.resize(decode_utf8(s, chars.data()));
+    return chars;
+}
+
+void encode_utf8(const std::u32string_view chars, std::string &out) {
+    for (const char32_t c : chars) {
+        if (c < 0x80) {
+            out.push_back(static_cast<char>(c));
+        } else if (c < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (c >> 6)));
+            out.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        } else if (c < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (c >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (c >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+}
+
+std::string encode_utf8(const std::u32string_view chars) {
+    std::string s;
+    encode_utf8(chars, s);
+    return s;
+}
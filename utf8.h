@@ -0,0 +1,28 @@
+#ifndef LEARNMON_UTF8_H
+#define LEARNMON_UTF8_H
+
+#include <cstddef>
+#include <expected>
+#include <string>
+#include <string_view>
+
+#include "csv_scanner.h"
+
+// Checks that `s` is well-formed UTF-8 (no overlong forms, surrogates or
+// codepoints above U+10FFFF). On failure the error is the byte offset of the
+// first invalid sequence. The AVX2 kernel checks 32 bytes at a time with table
+// lookups; SSE2 has no byte shuffle, so it uses the scalar kernel.
+std::expected<void, size_t> validate_utf8(std::string_view s);
+std::expected<void, size_t> validate_utf8(std::string_view s, ScanKernel kernel);
+
+// Decodes `s` into `out`, which must have room for s.size() codepoints, and
+// returns how many were written. A byte that does not start a complete sequence
+// is taken as a codepoint of its own, like split_word_to_chars does.
+size_t decode_utf8(std::string_view s, char32_t *out);
+std::u32string decode_utf8(std::string_view s);
+
+// Appends the UTF-8 encoding of `chars` to `out`.
+void encode_utf8(std::u32string_view chars, std::string &out);
+std::string encode_utf8(std::u32string_view chars);
+
+#endif //LEARNMON_UTF8_H